@@ -4,20 +4,46 @@
 #include <string.h>
 #include <time.h>
 #include <limits.h>
-
-#define MAX_MEM_BLKS 100
-#define MAX_PROC 20
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define BLOCK_CHUNK_SHIFT 12
+#define BLOCK_CHUNK_SIZE (1 << BLOCK_CHUNK_SHIFT)
+#define INIT_PROC_CAP 64
+#define BUDDY_ORDERS 31
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT 32
+#define FREE_HIST_BUCKETS 32
+#define USAGE_RING_SIZE 4096
+#define LAT_SUB_BITS 4
+#define LAT_SUB_COUNT (1 << LAT_SUB_BITS)
+#define LAT_BUCKETS (64 * LAT_SUB_COUNT)
+#define LAT_QUANTILES 4
+#define EVENT_LOG_SIZE 4096
 #define MEM_VIS_SIZE 60
 #define DEFAULT_IN_FILE "input.txt"
 #define MAX_LINE_LEN 1024
-
-int mem_capacity;
+#define TRACE_MAGIC "PA4TRACE"
+#define TRACE_VERSION 1
+#define DEFAULT_WINDOW 4096
+#define READ_BLOCK_SIZE (1 << 20)
 
 typedef enum
 {
     FIRST_APPROACH,
     BEST_APPROACH,
-    WORST_APPROACH
+    WORST_APPROACH,
+    NEXT_APPROACH,
+    BUDDY_APPROACH,
+    TLSF_APPROACH
 } AllocMethod;
 
 typedef enum
@@ -31,25 +57,141 @@ typedef struct
 {
     int begin_addr;
     int chunk_size;
+    int used_size;
     bool available;
     int proc_id;
+    int prev;
+    int next;
+    int list_prev;
+    int list_next;
+    int tree_left;
+    int tree_right;
+    unsigned int tree_prio;
+    int addr_left;
+    int addr_right;
+    unsigned int addr_prio;
+    int addr_max_free;
+    int heap_pos;
+    unsigned int gen;
 } MemBlock;
 
+typedef struct
+{
+    int slot;
+    unsigned int gen;
+} BlockHandle;
+
+static const BlockHandle NO_BLOCK = {-1, 0};
+
 typedef struct
 {
     int id;
     int req_size;
+    int arrival_time;
+    int duration;
     ProcStatus status;
-    int block_idx;
+    BlockHandle handle;
 } Proc;
 
+typedef struct
+{
+    long long time;
+    float util;
+    int free_blocks;
+    int largest;
+} UsageSample;
+
+typedef struct
+{
+    UsageSample *buf;
+    long long count;
+    long long spilled;
+    FILE *spill;
+    long long start_time;
+    long long last_time;
+    double last_util;
+    double area;
+} UsageRing;
+
+typedef struct
+{
+    long long counts[LAT_BUCKETS];
+    long long total;
+    unsigned long long max;
+} LatencyHist;
+
+typedef enum
+{
+    VERBOSITY_OFF,
+    VERBOSITY_BUFFERED,
+    VERBOSITY_TEXT
+} Verbosity;
+
+typedef enum
+{
+    LOG_ARRIVE,
+    LOG_ARRIVE_FAILED,
+    LOG_DEPART,
+    LOG_RELEASE,
+    LOG_COALESCE,
+    LOG_MERGED,
+    LOG_COMPACT,
+    LOG_PLACED
+} LogKind;
+
+typedef struct
+{
+    long long time;
+    LogKind kind;
+    int args[4];
+} LogRecord;
+
+typedef struct
+{
+    LogRecord *buf;
+    long long count;
+    long long flushed;
+} EventLog;
+
 typedef struct
 {
     int full_size;
     int avail_size;
     int num_blocks;
-    MemBlock segments[MAX_MEM_BLKS];
+    int head;
+    int spare_head;
+    MemBlock **block_chunks;
+    int num_chunks;
+    int chunk_slots;
+    int block_cap;
+    int size_root;
+    int addr_root;
+    unsigned int tree_seed;
+    int *free_heap;
+    int heap_len;
+    int rover_addr;
+    bool addr_indexed;
+    int order_heads[BUDDY_ORDERS];
+    unsigned int order_mask;
+    unsigned int tlsf_fl_map;
+    unsigned int tlsf_sl_map[TLSF_FL_COUNT];
+    int tlsf_heads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    int free_blocks;
+    int free_hist[FREE_HIST_BUCKETS];
+    long long int_frag;
+    UsageRing series;
+    LatencyHist alloc_lat;
+    LatencyHist free_lat;
+    EventLog log;
+    bool compact_on_fail;
+    int compactions;
+    long long compact_moved;
+    unsigned long long compact_ticks;
+    bool clocked;
+    long long now;
     AllocMethod method;
+    Verbosity verbosity;
+    FILE *out;
 } MemMgr;
 
 typedef struct
@@ -62,779 +204,4299 @@ typedef struct
     int ext_frag;
     double frag_percent;
     double avg_frag_size;
+    int int_frag;
+    double int_frag_percent;
+    double alloc_ns[LAT_QUANTILES];
+    double free_ns[LAT_QUANTILES];
+    int compactions;
+    long long compact_moved;
+    double compact_ms;
 } Stats;
 
-void init_mem_mgr(MemMgr *mgr, AllocMethod method);
-int find_first_fit(MemMgr *mgr, int size);
-int find_best_fit(MemMgr *mgr, int size);
-int find_worst_fit(MemMgr *mgr, int size);
-bool allocate_mem(MemMgr *mgr, Proc *proc);
-void free_mem(MemMgr *mgr, Proc *proc);
-bool merge_blocks(MemMgr *mgr, Proc procs[]);
-bool load_procs_from_file(const char *filename, Proc procs[], int *num_procs, int *mem_capacity);
-void print_mem_simple(MemMgr *mgr, Proc procs[], int num_procs);
-void print_mem_detailed(MemMgr *mgr, Proc procs[], int num_procs);
-void update_frag_metrics(MemMgr *mgr, Proc procs[], int num_procs, Stats *stats);
-void run_sim(MemMgr *mgr, AllocMethod method, Proc procs[], int num_procs, Stats *stats);
-
-int find_first_fit(MemMgr *mgr, int size)
+typedef enum
 {
-    for (int i = 0; i < mgr->num_blocks; i++)
-    {
-        if (mgr->segments[i].available && mgr->segments[i].chunk_size >= size)
-        {
-            return i;
-        }
-    }
-    return -1;
-}
+    EVENT_DEPART,
+    EVENT_ARRIVE
+} EventKind;
 
-int find_best_fit(MemMgr *mgr, int size)
+typedef struct
 {
-    int best_idx = -1;
-    int min_diff = INT_MAX;
+    long long time;
+    long long seq;
+    EventKind kind;
+    int slot;
+} SimEvent;
 
-    for (int i = 0; i < mgr->num_blocks; i++)
-    {
-        if (mgr->segments[i].available && mgr->segments[i].chunk_size >= size)
-        {
-            int size_diff = mgr->segments[i].chunk_size - size;
-            if (size_diff < min_diff)
-            {
-                min_diff = size_diff;
-                best_idx = i;
-            }
-        }
-    }
-    return best_idx;
-}
+typedef struct
+{
+    SimEvent *events;
+    int len;
+    int cap;
+} EventQueue;
 
-int find_worst_fit(MemMgr *mgr, int size)
+typedef struct
 {
-    int worst_idx = -1;
-    int max_diff = -1;
+    Proc *procs;
+    int *spare;
+    int num_spare;
+    int cap;
+} LiveTable;
 
-    for (int i = 0; i < mgr->num_blocks; i++)
-    {
-        if (mgr->segments[i].available && mgr->segments[i].chunk_size >= size)
-        {
-            int size_diff = mgr->segments[i].chunk_size - size;
-            if (size_diff > max_diff)
-            {
-                max_diff = size_diff;
-                worst_idx = i;
-            }
-        }
-    }
-    return worst_idx;
-}
+typedef bool (*ProcFeed)(void *ctx, Proc *out);
 
-bool merge_blocks(MemMgr *mgr, Proc procs[])
+typedef enum
 {
-    bool did_merge = false;
-    for (int i = 0; i < mgr->num_blocks - 1; i++)
-    {
-        if (mgr->segments[i].available && mgr->segments[i + 1].available)
-        {
-            mgr->segments[i].chunk_size += mgr->segments[i + 1].chunk_size;
-            for (int j = i + 1; j < mgr->num_blocks - 1; j++)
-            {
-                mgr->segments[j] = mgr->segments[j + 1];
-            }
-            mgr->num_blocks--;
-            did_merge = true;
+    FEED_DONE,
+    FEED_SCHEDULED,
+    FEED_NO_MEMORY
+} FeedStatus;
 
-            for (int k = 0; k < MAX_PROC; k++)
-            {
-                if (procs[k].block_idx > i + 1)
-                {
-                    procs[k].block_idx--;
-                }
-            }
-            i--;
-        }
-    }
-    return did_merge;
-}
+typedef enum
+{
+    OP_ALLOC,
+    OP_FREE,
+    OP_FREE_ALL,
+    OP_LARGE
+} ScriptOpKind;
 
-int main(int argc, char *argv[])
+typedef struct
 {
-    char in_file[256] = DEFAULT_IN_FILE;
+    ScriptOpKind kind;
+    int id;
+    int size;
+    float pct;
+} ScriptOp;
 
-    if (argc > 1)
-        strcpy(in_file, argv[1]);
+typedef struct
+{
+    int capacity;
+    ScriptOp *ops;
+    long long num_ops;
+    long long cap;
+} Script;
 
-    srand(time(NULL));
+typedef struct
+{
+    int *keys;
+    int *slots;
+    int cap;
+    int len;
+} ProcMap;
 
-    Proc procs[MAX_PROC];
-    int num_procs = 0;
-    int mem_capacity = 0;
+typedef enum
+{
+    SIZE_UNIFORM,
+    SIZE_EXPONENTIAL,
+    SIZE_PARETO,
+    SIZE_BIMODAL
+} SizeDist;
 
-    if (!load_procs_from_file(in_file, procs, &num_procs, &mem_capacity))
-    {
-        fprintf(stderr, "Failed to read processes from input file.\n");
-        return EXIT_FAILURE;
-    }
+typedef struct
+{
+    unsigned long long seed;
+    int count;
+    int capacity;
+    SizeDist dist;
+    int min_size;
+    int max_size;
+    double mean_size;
+    double alpha;
+    double big_frac;
+    double arrival_rate;
+    double mean_life;
+} GenConfig;
 
-    printf("\n===== STATIC MEMORY ALLOCATION SIMULATION =====\n\n");
-    printf("Input file: %s\n", in_file);
-    printf("Memory size: %d KB\n", mem_capacity);
-    printf("Number of processes: %d\n\n", num_procs);
+typedef struct
+{
+    unsigned long long state;
+} Rng;
 
-    printf("-------------------------------------------------\n");
-    printf("Processes Loaded:\n");
-    printf("%-10s %-10s\n", "ProcessID", "Size (KB)");
-    printf("-------------------------------------------------\n");
-    for (int i = 0; i < num_procs; i++)
-    {
-        printf("%-10d %-10d\n", procs[i].id, procs[i].req_size);
-    }
-    printf("\n");
+typedef struct
+{
+    const GenConfig *cfg;
+    Rng rng;
+    double clock;
+    int made;
+} GenFeed;
 
-    Stats perf_stats[3] = {0};
-    AllocMethod methods[3] = {FIRST_APPROACH, BEST_APPROACH, WORST_APPROACH};
+typedef struct
+{
+    char magic[8];
+    unsigned int version;
+    int capacity;
+    long long count;
+} TraceHeader;
 
-    for (int i = 0; i < 3; i++)
-    {
-        MemMgr mgr;
-        init_mem_mgr(&mgr, methods[i]);
+typedef struct
+{
+    int id;
+    int req_size;
+    int arrival_time;
+    int duration;
+} TraceRecord;
 
-        mgr.full_size = mem_capacity;
-        mgr.avail_size = mem_capacity;
-        mgr.segments[0].chunk_size = mem_capacity;
+typedef struct
+{
+    void *base;
+    size_t length;
+    const TraceHeader *header;
+    const TraceRecord *records;
+} MappedTrace;
 
-        Proc sim_procs[MAX_PROC];
-        memcpy(sim_procs, procs, sizeof(Proc) * num_procs);
+typedef struct
+{
+    const TraceRecord *records;
+    long long count;
+    long long pos;
+} MappedFeed;
 
-        run_sim(&mgr, methods[i], sim_procs, num_procs, &perf_stats[i]);
-    }
+typedef struct
+{
+    Proc proc;
+    long long seq;
+} PendingProc;
 
-    printf("\n=== Summary of Allocation Methods ===\n");
-    printf("%-10s %-15s %-15s %-15s\n", "Strategy", "Success Rate", "Fragmentation", "Block Count");
-    printf("----------------------------------------------------------\n");
+typedef struct
+{
+    FILE *in_file;
+    char *buf;
+    size_t cap;
+    size_t start;
+    size_t end;
+    bool eof;
+    long long bytes;
+} LineReader;
 
-    for (int i = 0; i < 3; i++)
-    {
-        char *method_name;
-        switch (methods[i])
-        {
-        case FIRST_APPROACH:
-            method_name = "First Fit";
-            break;
-        case BEST_APPROACH:
-            method_name = "Best Fit";
-            break;
-        case WORST_APPROACH:
-            method_name = "Worst Fit";
-            break;
-        default:
-            method_name = "Unknown";
-            break;
-        }
+typedef struct
+{
+    LineReader reader;
+    int line_num;
+    int capacity;
+    PendingProc *window;
+    int len;
+    int cap;
+    long long next_seq;
+    bool warn;
+} TextFeed;
 
-        double success_rate =
-            (perf_stats[i].alloc_tries > 0) ? ((double)perf_stats[i].alloc_success / perf_stats[i].alloc_tries * 100.0) : 0.0;
+typedef enum
+{
+    EXPORT_CSV,
+    EXPORT_JSON
+} ExportFormat;
 
-        char success_str[20], frag_str[20];
-        sprintf(success_str, "%.1f%%", success_rate);
-        sprintf(frag_str, "%.1f%%", perf_stats[i].frag_percent);
+typedef struct
+{
+    FILE *out;
+    ExportFormat format;
+    const char *source;
+    unsigned long long run_id;
+    pthread_mutex_t lock;
+} Exporter;
 
-        printf("%-10s %-15s %-15s %-15d\n",
-               method_name,
-               success_str,
-               frag_str,
-               perf_stats[i].ext_frag);
-    }
-}
+typedef struct
+{
+    const GenConfig *gen;
+    const AllocMethod *methods;
+    int num_methods;
+    int trials;
+    unsigned long long *seeds;
+    Stats *samples;
+    int next_job;
+    bool failed;
+    bool compact;
+    Exporter *exporter;
+    pthread_mutex_t lock;
+} SweepPool;
 
-void init_mem_mgr(MemMgr *mgr, AllocMethod method)
+typedef enum
 {
-    mgr->full_size = mem_capacity;
-    mgr->avail_size = mgr->full_size;
-    mgr->num_blocks = 1;
-    mgr->method = method;
+    RUN_INTERACTIVE,
+    RUN_SCRIPT,
+    RUN_GENERATED,
+    RUN_MAPPED,
+    RUN_STREAM
+} RunMode;
 
-    mgr->segments[0].begin_addr = 0;
-    mgr->segments[0].chunk_size = mgr->full_size;
-    mgr->segments[0].available = true;
-    mgr->segments[0].proc_id = -1;
+typedef struct
+{
+    RunMode mode;
+    AllocMethod method;
+    int capacity;
+    Verbosity verbosity;
+    Proc *procs;
+    int num_procs;
+    const Script *script;
+    const GenConfig *gen;
+    const MappedTrace *trace;
+    const char *in_file;
+    int window;
+    bool warn;
+    const char *series_prefix;
+    bool compact;
+    Exporter *exporter;
+    Stats *stats;
+    FILE *out;
+    char *out_buf;
+    size_t out_len;
+    bool ok;
+} StrategyRun;
+
+bool init_mem_mgr(MemMgr *mgr, AllocMethod method, int capacity);
+void destroy_mem_mgr(MemMgr *mgr);
+bool grow_block_pool(MemMgr *mgr);
+int block_alloc(MemMgr *mgr);
+void block_release(MemMgr *mgr, int blk);
+BlockHandle make_handle(MemMgr *mgr, int blk);
+int resolve_handle(MemMgr *mgr, BlockHandle handle);
+int carve_block(MemMgr *mgr, int blk, int size);
+void absorb_next_block(MemMgr *mgr, int blk);
+void free_tree_insert(MemMgr *mgr, int blk);
+void free_tree_remove(MemMgr *mgr, int blk);
+int free_tree_lower_bound(MemMgr *mgr, int size);
+void free_heap_push(MemMgr *mgr, int blk);
+void free_heap_remove(MemMgr *mgr, int blk);
+void free_heap_fix(MemMgr *mgr, int blk);
+void free_index_insert(MemMgr *mgr, int blk);
+void free_index_remove(MemMgr *mgr, int blk);
+void free_index_resize(MemMgr *mgr, int blk, int begin_addr, int chunk_size);
+void addr_tree_insert(MemMgr *mgr, int blk);
+void addr_tree_remove(MemMgr *mgr, int blk);
+void addr_tree_update(MemMgr *mgr, int blk);
+int largest_free_block(MemMgr *mgr);
+int find_first_fit(MemMgr *mgr, int size);
+int find_best_fit(MemMgr *mgr, int size);
+int find_worst_fit(MemMgr *mgr, int size);
+int find_next_fit(MemMgr *mgr, int size);
+int find_buddy_fit(MemMgr *mgr, int size);
+int buddy_split(MemMgr *mgr, int blk, int size);
+int find_tlsf_fit(MemMgr *mgr, int size);
+const char *method_title(AllocMethod method);
+bool allocate_mem(MemMgr *mgr, Proc *proc);
+bool can_compact(MemMgr *mgr, const Proc *proc);
+long long compact_mem(MemMgr *mgr);
+bool allocate_or_compact(MemMgr *mgr, Proc *proc);
+void finish_stats(MemMgr *mgr, Stats *stats);
+bool usage_ring_init(UsageRing *ring);
+bool usage_ring_spill_to(MemMgr *mgr, const char *filename);
+void usage_ring_close(UsageRing *ring);
+bool event_log_init(EventLog *log);
+void record_usage(MemMgr *mgr);
+double usage_time_average(MemMgr *mgr);
+double ticks_per_ns(void);
+void latency_quantiles(const LatencyHist *hist, double out_ns[LAT_QUANTILES]);
+void log_event(MemMgr *mgr, LogKind kind, int a, int b, int c, int d);
+void event_log_flush(MemMgr *mgr);
+void free_mem(MemMgr *mgr, Proc *proc);
+bool merge_blocks(MemMgr *mgr);
+bool line_reader_open(LineReader *reader, const char *filename);
+void line_reader_close(LineReader *reader);
+bool line_reader_next(LineReader *reader, const char **line, size_t *len);
+bool parse_capacity_line(const char *line, size_t len, int *capacity);
+bool parse_proc_line(const char *line, size_t len, int line_num, Proc *proc, bool warn);
+bool load_procs_from_file(const char *filename, Proc **procs, int *num_procs, int *mem_capacity, long long *bytes_read);
+void print_mem_simple(MemMgr *mgr, Proc procs[], int num_procs);
+void print_mem_detailed(MemMgr *mgr, Proc procs[], int num_procs);
+void update_frag_metrics(MemMgr *mgr, Stats *stats);
+void run_sim(MemMgr *mgr, AllocMethod method, Proc procs[], int num_procs, Stats *stats);
+void print_summary(const AllocMethod methods[], const Stats stats[], int num_methods);
+void *run_strategy(void *arg);
+void gen_feed_init(GenFeed *feed, const GenConfig *cfg);
+bool gen_feed_next(void *ctx, Proc *out);
+const char *size_dist_name(SizeDist dist);
+bool parse_gen_spec(const char *spec, GenConfig *cfg);
+bool write_workload(const char *filename, const GenConfig *cfg);
+void *sweep_worker(void *arg);
+bool run_sweep(const GenConfig *gen, const AllocMethod methods[], int num_methods, int trials, bool compact,
+               Exporter *exporter);
+void print_sweep_summary(const AllocMethod methods[], int num_methods, const Stats samples[], int trials);
+bool is_binary_trace(const char *filename);
+bool map_trace(const char *filename, MappedTrace *trace);
+void unmap_trace(MappedTrace *trace);
+bool mapped_feed_next(void *ctx, Proc *out);
+bool load_procs_from_trace(const char *filename, Proc **procs, int *num_procs, int *mem_capacity, long long *bytes_read);
+bool convert_trace(const char *text_file, const char *bin_file);
+bool text_feed_open(TextFeed *feed, const char *filename, int window, bool warn);
+void text_feed_close(TextFeed *feed);
+bool text_feed_next(void *ctx, Proc *out);
+bool exporter_open(Exporter *exp, const char *filename, const char *source);
+void exporter_close(Exporter *exp);
+void export_run(Exporter *exp, MemMgr *mgr, const char *mode, unsigned long long seed,
+                const Stats *stats, double elapsed);
+bool event_queue_push(EventQueue *queue, SimEvent event);
+bool event_queue_pop(EventQueue *queue, SimEvent *out);
+bool run_event_sim(MemMgr *mgr, ProcFeed feed, void *feed_ctx, Stats *stats);
+int *sort_by_arrival(Proc procs[], int num_procs);
+int proc_map_find(ProcMap *map, int id);
+bool proc_map_put(ProcMap *map, int id, int slot);
+void proc_map_remove(ProcMap *map, int id);
+bool load_script(const char *filename, Script *script);
+void run_script(MemMgr *mgr, const Script *script, Stats *stats);
+
+static inline MemBlock *block_at(MemMgr *mgr, int blk)
+{
+    return &mgr->block_chunks[blk >> BLOCK_CHUNK_SHIFT][blk & (BLOCK_CHUNK_SIZE - 1)];
 }
 
-bool allocate_mem(MemMgr *mgr, Proc *proc)
+bool grow_block_pool(MemMgr *mgr)
 {
-    if (proc->req_size > mgr->avail_size)
+    if (mgr->num_chunks == mgr->chunk_slots)
     {
-        return false;
+        int slots = (mgr->chunk_slots > 0) ? mgr->chunk_slots * 2 : 8;
+        MemBlock **chunks = realloc(mgr->block_chunks, sizeof(MemBlock *) * slots);
+        if (chunks == NULL)
+            return false;
+        mgr->block_chunks = chunks;
+        mgr->chunk_slots = slots;
     }
 
-    int block_idx = -1;
+    int *heap = realloc(mgr->free_heap, sizeof(int) * (mgr->block_cap + BLOCK_CHUNK_SIZE));
+    if (heap == NULL)
+        return false;
+    mgr->free_heap = heap;
 
-    switch (mgr->method)
-    {
-    case FIRST_APPROACH:
-        block_idx = find_first_fit(mgr, proc->req_size);
-        break;
-    case BEST_APPROACH:
-        block_idx = find_best_fit(mgr, proc->req_size);
-        break;
-    case WORST_APPROACH:
-        block_idx = find_worst_fit(mgr, proc->req_size);
-        break;
-    }
+    MemBlock *chunk = malloc(sizeof(MemBlock) * BLOCK_CHUNK_SIZE);
+    if (chunk == NULL)
+        return false;
+    mgr->block_chunks[mgr->num_chunks++] = chunk;
 
-    if (block_idx == -1)
+    int base = mgr->block_cap;
+    mgr->block_cap += BLOCK_CHUNK_SIZE;
+
+    for (int i = BLOCK_CHUNK_SIZE - 1; i >= 0; i--)
     {
-        return false;
+        chunk[i].gen = 0;
+        chunk[i].next = mgr->spare_head;
+        mgr->spare_head = base + i;
     }
+    return true;
+}
 
-    if (mgr->segments[block_idx].chunk_size > proc->req_size + 10)
+int block_alloc(MemMgr *mgr)
+{
+    if (mgr->spare_head == -1 && !grow_block_pool(mgr))
     {
-        if (mgr->num_blocks >= MAX_MEM_BLKS)
-        {
-            return false;
-        }
-
-        for (int i = mgr->num_blocks; i > block_idx + 1; i--)
-        {
-            mgr->segments[i] = mgr->segments[i - 1];
-        }
+        return -1;
+    }
 
-        mgr->segments[block_idx + 1].begin_addr =
-            mgr->segments[block_idx].begin_addr + proc->req_size;
-        mgr->segments[block_idx + 1].chunk_size =
-            mgr->segments[block_idx].chunk_size - proc->req_size;
-        mgr->segments[block_idx + 1].available = true;
-        mgr->segments[block_idx + 1].proc_id = -1;
+    int blk = mgr->spare_head;
+    mgr->spare_head = block_at(mgr, blk)->next;
+    mgr->num_blocks++;
+    return blk;
+}
 
-        mgr->segments[block_idx].chunk_size = proc->req_size;
+void block_release(MemMgr *mgr, int blk)
+{
+    block_at(mgr, blk)->gen++;
+    block_at(mgr, blk)->next = mgr->spare_head;
+    mgr->spare_head = blk;
+    mgr->num_blocks--;
+}
 
-        mgr->num_blocks++;
-    }
+BlockHandle make_handle(MemMgr *mgr, int blk)
+{
+    BlockHandle handle = {blk, block_at(mgr, blk)->gen};
+    return handle;
+}
 
-    mgr->segments[block_idx].available = false;
-    mgr->segments[block_idx].proc_id = proc->id;
-    proc->block_idx = block_idx;
-    proc->status = PROC_ACTIVE;
-    mgr->avail_size -= proc->req_size;
+int resolve_handle(MemMgr *mgr, BlockHandle handle)
+{
+    if (handle.slot < 0 || handle.slot >= mgr->block_cap)
+        return -1;
 
-    return true;
+    MemBlock *b = block_at(mgr, handle.slot);
+    if (b->gen != handle.gen || b->available)
+        return -1;
+    return handle.slot;
 }
 
-void free_mem(MemMgr *mgr, Proc *proc)
+int carve_block(MemMgr *mgr, int blk, int size)
 {
-    if (proc->block_idx == -1)
+    int front = block_alloc(mgr);
+    if (front == -1)
     {
-        return;
+        return -1;
     }
 
-    int idx = proc->block_idx;
+    MemBlock *b = block_at(mgr, blk);
+    MemBlock *f = block_at(mgr, front);
+
+    f->begin_addr = b->begin_addr;
+    f->chunk_size = size;
+    f->available = true;
+    f->proc_id = -1;
+    f->next = blk;
+    f->prev = b->prev;
+    if (b->prev != -1)
+        block_at(mgr, b->prev)->next = front;
+    else
+        mgr->head = front;
+    b->prev = front;
 
-    mgr->segments[idx].available = true;
-    mgr->segments[idx].proc_id = -1;
-    mgr->avail_size += mgr->segments[idx].chunk_size;
+    free_index_resize(mgr, blk, b->begin_addr + size, b->chunk_size - size);
+    addr_tree_update(mgr, blk);
+    addr_tree_insert(mgr, front);
 
-    proc->status = PROC_DONE;
-    proc->block_idx = -1;
+    return front;
+}
 
-    bool merged;
-    int merge_ops = 0;
+void absorb_next_block(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+    int gone = b->next;
+    MemBlock *g = block_at(mgr, gone);
 
-    printf("\nCoalescing Process: Checking for adjacent free blocks after P%d termination\n", proc->id);
+    free_index_remove(mgr, gone);
+    addr_tree_remove(mgr, gone);
 
-    do
-    {
-        merged = false;
+    if (mgr->rover_addr == g->begin_addr)
+        mgr->rover_addr = b->begin_addr;
 
-        for (int i = 0; i < mgr->num_blocks - 1; i++)
-        {
-            if (mgr->segments[i].available && mgr->segments[i + 1].available)
-            {
-                printf("  Coalescing blocks at addresses %d and %d (sizes: %d KB + %d KB = %d KB)\n",
-                       mgr->segments[i].begin_addr,
-                       mgr->segments[i + 1].begin_addr,
-                       mgr->segments[i].chunk_size,
-                       mgr->segments[i + 1].chunk_size,
-                       mgr->segments[i].chunk_size + mgr->segments[i + 1].chunk_size);
+    free_index_resize(mgr, blk, b->begin_addr, b->chunk_size + g->chunk_size);
+    b->next = g->next;
+    if (g->next != -1)
+        block_at(mgr, g->next)->prev = blk;
 
-                mgr->segments[i].chunk_size += mgr->segments[i + 1].chunk_size;
+    block_release(mgr, gone);
+    addr_tree_update(mgr, blk);
+}
 
-                for (int j = i + 1; j < mgr->num_blocks - 1; j++)
-                {
-                    mgr->segments[j] = mgr->segments[j + 1];
-                }
+static int free_key_cmp(MemBlock *a, MemBlock *b)
+{
+    if (a->chunk_size != b->chunk_size)
+        return (a->chunk_size < b->chunk_size) ? -1 : 1;
+    if (a->begin_addr != b->begin_addr)
+        return (a->begin_addr < b->begin_addr) ? -1 : 1;
+    return 0;
+}
 
-                for (int j = 0; j < MAX_PROC; j++)
-                {
-                    if (proc[j].block_idx > i + 1)
-                    {
-                        proc[j].block_idx--;
-                    }
-                }
+static unsigned int next_tree_prio(MemMgr *mgr)
+{
+    mgr->tree_seed ^= mgr->tree_seed << 13;
+    mgr->tree_seed ^= mgr->tree_seed >> 17;
+    mgr->tree_seed ^= mgr->tree_seed << 5;
+    return mgr->tree_seed;
+}
 
-                mgr->num_blocks--;
-                merged = true;
-                merge_ops++;
-                break;
-            }
-        }
-    } while (merged);
+static int free_tree_rotate_right(MemMgr *mgr, int n)
+{
+    int l = block_at(mgr, n)->tree_left;
+    block_at(mgr, n)->tree_left = block_at(mgr, l)->tree_right;
+    block_at(mgr, l)->tree_right = n;
+    return l;
+}
+
+static int free_tree_rotate_left(MemMgr *mgr, int n)
+{
+    int r = block_at(mgr, n)->tree_right;
+    block_at(mgr, n)->tree_right = block_at(mgr, r)->tree_left;
+    block_at(mgr, r)->tree_left = n;
+    return r;
+}
+
+static int free_tree_insert_at(MemMgr *mgr, int n, int blk)
+{
+    if (n == -1)
+        return blk;
+
+    MemBlock *cur = block_at(mgr, n);
 
-    if (merge_ops == 0)
+    if (free_key_cmp(block_at(mgr, blk), cur) < 0)
     {
-        printf("  No adjacent free blocks found for coalescing\n");
+        cur->tree_left = free_tree_insert_at(mgr, cur->tree_left, blk);
+        if (block_at(mgr, cur->tree_left)->tree_prio > cur->tree_prio)
+            n = free_tree_rotate_right(mgr, n);
     }
     else
     {
-        printf("  Completed %d coalescing operations\n", merge_ops);
+        cur->tree_right = free_tree_insert_at(mgr, cur->tree_right, blk);
+        if (block_at(mgr, cur->tree_right)->tree_prio > cur->tree_prio)
+            n = free_tree_rotate_left(mgr, n);
     }
+    return n;
 }
 
-bool load_procs_from_file(const char *filename, Proc procs[], int *num_procs, int *mem_capacity)
+static int free_tree_remove_at(MemMgr *mgr, int n, int blk)
 {
-    FILE *in_file = fopen(filename, "r");
-    if (in_file == NULL)
+    if (n == -1)
+        return -1;
+
+    MemBlock *cur = block_at(mgr, n);
+
+    if (n != blk)
     {
-        fprintf(stderr, "Error: Could not open input file '%s'\n", filename);
-        return false;
+        if (free_key_cmp(block_at(mgr, blk), cur) < 0)
+            cur->tree_left = free_tree_remove_at(mgr, cur->tree_left, blk);
+        else
+            cur->tree_right = free_tree_remove_at(mgr, cur->tree_right, blk);
+        return n;
     }
 
-    char line[MAX_LINE_LEN];
-    int line_num = 0;
-
-    if (fgets(line, MAX_LINE_LEN, in_file) != NULL)
+    if (cur->tree_left == -1 || cur->tree_right == -1)
     {
-        line_num++;
-        int mem_size;
-        if (sscanf(line, "%d", &mem_size) == 1)
-        {
-            *mem_capacity = mem_size;
-        }
+        return (cur->tree_left != -1) ? cur->tree_left : cur->tree_right;
     }
 
-    *num_procs = 0;
-    while (fgets(line, MAX_LINE_LEN, in_file) != NULL && *num_procs < MAX_PROC)
+    if (block_at(mgr, cur->tree_left)->tree_prio > block_at(mgr, cur->tree_right)->tree_prio)
     {
-        line_num++;
+        n = free_tree_rotate_right(mgr, n);
+        block_at(mgr, n)->tree_right = free_tree_remove_at(mgr, block_at(mgr, n)->tree_right, blk);
+    }
+    else
+    {
+        n = free_tree_rotate_left(mgr, n);
+        block_at(mgr, n)->tree_left = free_tree_remove_at(mgr, block_at(mgr, n)->tree_left, blk);
+    }
+    return n;
+}
 
-        if (line[0] == '\n' || line[0] == '#')
-        {
-            continue;
-        }
+void free_tree_insert(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+
+    b->tree_left = -1;
+    b->tree_right = -1;
+    b->tree_prio = next_tree_prio(mgr);
+
+    mgr->size_root = free_tree_insert_at(mgr, mgr->size_root, blk);
+}
+
+void free_tree_remove(MemMgr *mgr, int blk)
+{
+    mgr->size_root = free_tree_remove_at(mgr, mgr->size_root, blk);
+}
+
+int free_tree_lower_bound(MemMgr *mgr, int size)
+{
+    int found = -1;
+    int n = mgr->size_root;
+
+    while (n != -1)
+    {
+        if (block_at(mgr, n)->chunk_size >= size)
+        {
+            found = n;
+            n = block_at(mgr, n)->tree_left;
+        }
+        else
+        {
+            n = block_at(mgr, n)->tree_right;
+        }
+    }
+    return found;
+}
+
+static bool free_heap_before(MemMgr *mgr, int a, int b)
+{
+    MemBlock *x = block_at(mgr, a);
+    MemBlock *y = block_at(mgr, b);
+
+    if (x->chunk_size != y->chunk_size)
+        return x->chunk_size > y->chunk_size;
+    return x->begin_addr < y->begin_addr;
+}
+
+static void free_heap_place(MemMgr *mgr, int pos, int blk)
+{
+    mgr->free_heap[pos] = blk;
+    block_at(mgr, blk)->heap_pos = pos;
+}
+
+static void free_heap_sift_up(MemMgr *mgr, int pos)
+{
+    int blk = mgr->free_heap[pos];
+
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (!free_heap_before(mgr, blk, mgr->free_heap[parent]))
+            break;
+        free_heap_place(mgr, pos, mgr->free_heap[parent]);
+        pos = parent;
+    }
+    free_heap_place(mgr, pos, blk);
+}
+
+static void free_heap_sift_down(MemMgr *mgr, int pos)
+{
+    int blk = mgr->free_heap[pos];
+
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= mgr->heap_len)
+            break;
+        if (child + 1 < mgr->heap_len &&
+            free_heap_before(mgr, mgr->free_heap[child + 1], mgr->free_heap[child]))
+            child++;
+        if (!free_heap_before(mgr, mgr->free_heap[child], blk))
+            break;
+        free_heap_place(mgr, pos, mgr->free_heap[child]);
+        pos = child;
+    }
+    free_heap_place(mgr, pos, blk);
+}
+
+void free_heap_push(MemMgr *mgr, int blk)
+{
+    free_heap_place(mgr, mgr->heap_len, blk);
+    mgr->heap_len++;
+    free_heap_sift_up(mgr, mgr->heap_len - 1);
+}
+
+void free_heap_remove(MemMgr *mgr, int blk)
+{
+    int pos = block_at(mgr, blk)->heap_pos;
+    int last = mgr->free_heap[--mgr->heap_len];
+
+    block_at(mgr, blk)->heap_pos = -1;
+    if (last == blk)
+        return;
+
+    free_heap_place(mgr, pos, last);
+    free_heap_fix(mgr, last);
+}
+
+void free_heap_fix(MemMgr *mgr, int blk)
+{
+    int pos = block_at(mgr, blk)->heap_pos;
+
+    if (pos > 0 && free_heap_before(mgr, blk, mgr->free_heap[(pos - 1) / 2]))
+        free_heap_sift_up(mgr, pos);
+    else
+        free_heap_sift_down(mgr, pos);
+}
+
+static int buddy_order(int size)
+{
+    return (size <= 1) ? 0 : 32 - __builtin_clz((unsigned int)(size - 1));
+}
+
+static void order_list_push(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+    int order = buddy_order(b->chunk_size);
+
+    b->list_prev = -1;
+    b->list_next = mgr->order_heads[order];
+    if (b->list_next != -1)
+        block_at(mgr, b->list_next)->list_prev = blk;
+    mgr->order_heads[order] = blk;
+    mgr->order_mask |= 1u << order;
+}
+
+static void order_list_unlink(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+    int order = buddy_order(b->chunk_size);
+
+    if (b->list_prev != -1)
+        block_at(mgr, b->list_prev)->list_next = b->list_next;
+    else
+        mgr->order_heads[order] = b->list_next;
+    if (b->list_next != -1)
+        block_at(mgr, b->list_next)->list_prev = b->list_prev;
+
+    if (mgr->order_heads[order] == -1)
+        mgr->order_mask &= ~(1u << order);
+}
+
+static void tlsf_mapping(unsigned int size, int *fl, int *sl)
+{
+    if (size < TLSF_SL_COUNT)
+    {
+        *fl = 0;
+        *sl = (int)size;
+        return;
+    }
+
+    int log2 = 31 - __builtin_clz(size);
+    *fl = log2 - TLSF_SL_LOG2 + 1;
+    *sl = (int)((size >> (log2 - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT);
+}
+
+static void tlsf_list_push(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+    int fl, sl;
+
+    tlsf_mapping((unsigned int)b->chunk_size, &fl, &sl);
+
+    b->list_prev = -1;
+    b->list_next = mgr->tlsf_heads[fl][sl];
+    if (b->list_next != -1)
+        block_at(mgr, b->list_next)->list_prev = blk;
+    mgr->tlsf_heads[fl][sl] = blk;
+    mgr->tlsf_sl_map[fl] |= 1u << sl;
+    mgr->tlsf_fl_map |= 1u << fl;
+}
+
+static void tlsf_list_unlink(MemMgr *mgr, int blk)
+{
+    MemBlock *b = block_at(mgr, blk);
+    int fl, sl;
+
+    tlsf_mapping((unsigned int)b->chunk_size, &fl, &sl);
+
+    if (b->list_prev != -1)
+        block_at(mgr, b->list_prev)->list_next = b->list_next;
+    else
+        mgr->tlsf_heads[fl][sl] = b->list_next;
+    if (b->list_next != -1)
+        block_at(mgr, b->list_next)->list_prev = b->list_prev;
+
+    if (mgr->tlsf_heads[fl][sl] == -1)
+    {
+        mgr->tlsf_sl_map[fl] &= ~(1u << sl);
+        if (mgr->tlsf_sl_map[fl] == 0)
+            mgr->tlsf_fl_map &= ~(1u << fl);
+    }
+}
+
+static inline int free_hist_bucket(int size)
+{
+    return (size > 0) ? 31 - __builtin_clz((unsigned int)size) : 0;
+}
+
+void free_index_insert(MemMgr *mgr, int blk)
+{
+    mgr->free_blocks++;
+    mgr->free_hist[free_hist_bucket(block_at(mgr, blk)->chunk_size)]++;
+
+    switch (mgr->method)
+    {
+    case BEST_APPROACH:
+        free_tree_insert(mgr, blk);
+        break;
+    case WORST_APPROACH:
+        free_heap_push(mgr, blk);
+        break;
+    case BUDDY_APPROACH:
+        order_list_push(mgr, blk);
+        break;
+    case TLSF_APPROACH:
+        tlsf_list_push(mgr, blk);
+        free_heap_push(mgr, blk);
+        break;
+    default:
+        break;
+    }
+}
+
+void free_index_remove(MemMgr *mgr, int blk)
+{
+    mgr->free_blocks--;
+    mgr->free_hist[free_hist_bucket(block_at(mgr, blk)->chunk_size)]--;
+
+    switch (mgr->method)
+    {
+    case BEST_APPROACH:
+        free_tree_remove(mgr, blk);
+        break;
+    case WORST_APPROACH:
+        free_heap_remove(mgr, blk);
+        break;
+    case BUDDY_APPROACH:
+        order_list_unlink(mgr, blk);
+        break;
+    case TLSF_APPROACH:
+        tlsf_list_unlink(mgr, blk);
+        free_heap_remove(mgr, blk);
+        break;
+    default:
+        break;
+    }
+}
+
+void free_index_resize(MemMgr *mgr, int blk, int begin_addr, int chunk_size)
+{
+    MemBlock *b = block_at(mgr, blk);
+
+    mgr->free_hist[free_hist_bucket(b->chunk_size)]--;
+    mgr->free_hist[free_hist_bucket(chunk_size)]++;
+
+    if (mgr->method == BEST_APPROACH)
+        free_tree_remove(mgr, blk);
+    else if (mgr->method == BUDDY_APPROACH)
+        order_list_unlink(mgr, blk);
+    else if (mgr->method == TLSF_APPROACH)
+        tlsf_list_unlink(mgr, blk);
+
+    b->begin_addr = begin_addr;
+    b->chunk_size = chunk_size;
+
+    if (mgr->method == BEST_APPROACH)
+        free_tree_insert(mgr, blk);
+    else if (mgr->method == WORST_APPROACH)
+        free_heap_fix(mgr, blk);
+    else if (mgr->method == BUDDY_APPROACH)
+        order_list_push(mgr, blk);
+    else if (mgr->method == TLSF_APPROACH)
+    {
+        tlsf_list_push(mgr, blk);
+        free_heap_fix(mgr, blk);
+    }
+}
+
+static int addr_subtree_max(MemMgr *mgr, int n)
+{
+    return (n == -1) ? 0 : block_at(mgr, n)->addr_max_free;
+}
+
+static void addr_tree_pull(MemMgr *mgr, int n)
+{
+    MemBlock *b = block_at(mgr, n);
+    int best = b->available ? b->chunk_size : 0;
+    int l = addr_subtree_max(mgr, b->addr_left);
+    int r = addr_subtree_max(mgr, b->addr_right);
+
+    if (l > best)
+        best = l;
+    if (r > best)
+        best = r;
+    b->addr_max_free = best;
+}
+
+static int addr_tree_rotate_right(MemMgr *mgr, int n)
+{
+    int l = block_at(mgr, n)->addr_left;
+    block_at(mgr, n)->addr_left = block_at(mgr, l)->addr_right;
+    block_at(mgr, l)->addr_right = n;
+    addr_tree_pull(mgr, n);
+    addr_tree_pull(mgr, l);
+    return l;
+}
+
+static int addr_tree_rotate_left(MemMgr *mgr, int n)
+{
+    int r = block_at(mgr, n)->addr_right;
+    block_at(mgr, n)->addr_right = block_at(mgr, r)->addr_left;
+    block_at(mgr, r)->addr_left = n;
+    addr_tree_pull(mgr, n);
+    addr_tree_pull(mgr, r);
+    return r;
+}
+
+static int addr_tree_insert_at(MemMgr *mgr, int n, int blk)
+{
+    if (n == -1)
+        return blk;
+
+    MemBlock *cur = block_at(mgr, n);
+
+    if (block_at(mgr, blk)->begin_addr < cur->begin_addr)
+    {
+        cur->addr_left = addr_tree_insert_at(mgr, cur->addr_left, blk);
+        if (block_at(mgr, cur->addr_left)->addr_prio > cur->addr_prio)
+            return addr_tree_rotate_right(mgr, n);
+    }
+    else
+    {
+        cur->addr_right = addr_tree_insert_at(mgr, cur->addr_right, blk);
+        if (block_at(mgr, cur->addr_right)->addr_prio > cur->addr_prio)
+            return addr_tree_rotate_left(mgr, n);
+    }
+    addr_tree_pull(mgr, n);
+    return n;
+}
+
+static int addr_tree_remove_at(MemMgr *mgr, int n, int blk)
+{
+    if (n == -1)
+        return -1;
+
+    MemBlock *cur = block_at(mgr, n);
+
+    if (n != blk)
+    {
+        if (block_at(mgr, blk)->begin_addr < cur->begin_addr)
+            cur->addr_left = addr_tree_remove_at(mgr, cur->addr_left, blk);
+        else
+            cur->addr_right = addr_tree_remove_at(mgr, cur->addr_right, blk);
+        addr_tree_pull(mgr, n);
+        return n;
+    }
+
+    if (cur->addr_left == -1 || cur->addr_right == -1)
+    {
+        return (cur->addr_left != -1) ? cur->addr_left : cur->addr_right;
+    }
+
+    if (block_at(mgr, cur->addr_left)->addr_prio > block_at(mgr, cur->addr_right)->addr_prio)
+    {
+        n = addr_tree_rotate_right(mgr, n);
+        block_at(mgr, n)->addr_right = addr_tree_remove_at(mgr, block_at(mgr, n)->addr_right, blk);
+    }
+    else
+    {
+        n = addr_tree_rotate_left(mgr, n);
+        block_at(mgr, n)->addr_left = addr_tree_remove_at(mgr, block_at(mgr, n)->addr_left, blk);
+    }
+    addr_tree_pull(mgr, n);
+    return n;
+}
+
+static void addr_tree_update_at(MemMgr *mgr, int n, int blk)
+{
+    if (n == -1)
+        return;
+
+    if (n != blk)
+    {
+        if (block_at(mgr, blk)->begin_addr < block_at(mgr, n)->begin_addr)
+            addr_tree_update_at(mgr, block_at(mgr, n)->addr_left, blk);
+        else
+            addr_tree_update_at(mgr, block_at(mgr, n)->addr_right, blk);
+    }
+    addr_tree_pull(mgr, n);
+}
+
+void addr_tree_insert(MemMgr *mgr, int blk)
+{
+    if (!mgr->addr_indexed)
+        return;
+
+    MemBlock *b = block_at(mgr, blk);
+
+    b->addr_left = -1;
+    b->addr_right = -1;
+    b->addr_prio = next_tree_prio(mgr);
+    addr_tree_pull(mgr, blk);
+
+    mgr->addr_root = addr_tree_insert_at(mgr, mgr->addr_root, blk);
+}
+
+void addr_tree_remove(MemMgr *mgr, int blk)
+{
+    if (!mgr->addr_indexed)
+        return;
+
+    mgr->addr_root = addr_tree_remove_at(mgr, mgr->addr_root, blk);
+}
+
+void addr_tree_update(MemMgr *mgr, int blk)
+{
+    if (!mgr->addr_indexed)
+        return;
+
+    addr_tree_update_at(mgr, mgr->addr_root, blk);
+}
+
+int largest_free_block(MemMgr *mgr)
+{
+    if (mgr->method == BUDDY_APPROACH)
+        return (mgr->order_mask == 0) ? 0 : 1 << (31 - __builtin_clz(mgr->order_mask));
+
+    /* a size class spans a range of sizes, so TLSF keeps the exact maximum in the worst-fit heap */
+    if (mgr->method == TLSF_APPROACH)
+        return (mgr->heap_len == 0) ? 0 : block_at(mgr, mgr->free_heap[0])->chunk_size;
+
+    return addr_subtree_max(mgr, mgr->addr_root);
+}
+
+int find_first_fit(MemMgr *mgr, int size)
+{
+    int n = mgr->addr_root;
+
+    if (addr_subtree_max(mgr, n) < size)
+    {
+        return -1;
+    }
+
+    while (n != -1)
+    {
+        MemBlock *b = block_at(mgr, n);
+
+        if (addr_subtree_max(mgr, b->addr_left) >= size)
+            n = b->addr_left;
+        else if (b->available && b->chunk_size >= size)
+            return n;
+        else
+            n = b->addr_right;
+    }
+    return -1;
+}
+
+static int addr_tree_fit_from(MemMgr *mgr, int n, int size, int min_addr)
+{
+    if (addr_subtree_max(mgr, n) < size)
+        return -1;
+
+    MemBlock *b = block_at(mgr, n);
+
+    if (b->begin_addr < min_addr)
+        return addr_tree_fit_from(mgr, b->addr_right, size, min_addr);
+
+    int found = addr_tree_fit_from(mgr, b->addr_left, size, min_addr);
+    if (found != -1)
+        return found;
+    if (b->available && b->chunk_size >= size)
+        return n;
+    return addr_tree_fit_from(mgr, b->addr_right, size, min_addr);
+}
+
+int find_next_fit(MemMgr *mgr, int size)
+{
+    int blk = addr_tree_fit_from(mgr, mgr->addr_root, size, mgr->rover_addr);
+    if (blk == -1)
+    {
+        blk = find_first_fit(mgr, size);
+    }
+    return blk;
+}
+
+int find_buddy_fit(MemMgr *mgr, int size)
+{
+    int order = buddy_order(size);
+    if (order >= BUDDY_ORDERS)
+    {
+        return -1;
+    }
+
+    unsigned int usable = mgr->order_mask & ~((1u << order) - 1);
+    if (usable == 0)
+    {
+        return -1;
+    }
+    return mgr->order_heads[__builtin_ctz(usable)];
+}
+
+int buddy_split(MemMgr *mgr, int blk, int size)
+{
+    int order = buddy_order(size);
+
+    while (block_at(mgr, blk)->chunk_size > (1 << order))
+    {
+        int front = carve_block(mgr, blk, block_at(mgr, blk)->chunk_size / 2);
+        if (front == -1)
+        {
+            return -1;
+        }
+        free_index_insert(mgr, front);
+        blk = front;
+    }
+
+    free_index_remove(mgr, blk);
+    return blk;
+}
+
+/* the start of the next size class, so every block found from there fits without a list walk */
+static unsigned int tlsf_round_up(unsigned int size)
+{
+    if (size >= TLSF_SL_COUNT)
+    {
+        size += (1u << (31 - __builtin_clz(size) - TLSF_SL_LOG2)) - 1;
+    }
+    return size;
+}
+
+int find_tlsf_fit(MemMgr *mgr, int size)
+{
+    int fl, sl;
+
+    tlsf_mapping(tlsf_round_up((unsigned int)size), &fl, &sl);
+    if (fl >= TLSF_FL_COUNT)
+    {
+        return -1;
+    }
+
+    unsigned int sl_map = mgr->tlsf_sl_map[fl] & (~0u << sl);
+    if (sl_map == 0)
+    {
+        unsigned int fl_map = (fl + 1 < TLSF_FL_COUNT) ? mgr->tlsf_fl_map & (~0u << (fl + 1)) : 0;
+        if (fl_map == 0)
+        {
+            return -1;
+        }
+        fl = __builtin_ctz(fl_map);
+        sl_map = mgr->tlsf_sl_map[fl];
+    }
+    return mgr->tlsf_heads[fl][__builtin_ctz(sl_map)];
+}
+
+int find_best_fit(MemMgr *mgr, int size)
+{
+    return free_tree_lower_bound(mgr, size);
+}
+
+int find_worst_fit(MemMgr *mgr, int size)
+{
+    if (mgr->heap_len == 0 || block_at(mgr, mgr->free_heap[0])->chunk_size < size)
+    {
+        return -1;
+    }
+    return mgr->free_heap[0];
+}
+
+bool merge_blocks(MemMgr *mgr)
+{
+    bool did_merge = false;
+    int i = mgr->head;
+
+    while (i != -1 && block_at(mgr, i)->next != -1)
+    {
+        int nxt = block_at(mgr, i)->next;
+        if (block_at(mgr, i)->available && block_at(mgr, nxt)->available)
+        {
+            absorb_next_block(mgr, i);
+            did_merge = true;
+        }
+        else
+        {
+            i = nxt;
+        }
+    }
+    return did_merge;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *in_file = DEFAULT_IN_FILE;
+    Verbosity verbosity = VERBOSITY_TEXT;
+    bool event_mode = false;
+    bool parallel = false;
+    bool compact = false;
+    const char *script_file = NULL;
+    const char *gen_spec = NULL;
+    const char *gen_out = NULL;
+    int trials = 0;
+    const char *bin_out = NULL;
+    int window = DEFAULT_WINDOW;
+    const char *series_prefix = NULL;
+    const char *export_file = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+            verbosity = VERBOSITY_OFF;
+        else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+        {
+            int level = atoi(argv[++i]);
+            verbosity = (level <= 0) ? VERBOSITY_OFF : (level == 1) ? VERBOSITY_BUFFERED : VERBOSITY_TEXT;
+        }
+        else if (strcmp(argv[i], "-e") == 0)
+            event_mode = true;
+        else if (strcmp(argv[i], "-j") == 0)
+            parallel = true;
+        else if (strcmp(argv[i], "-c") == 0)
+            compact = true;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            script_file = argv[++i];
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            gen_spec = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            gen_out = argv[++i];
+        else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc)
+            bin_out = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            series_prefix = argv[++i];
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+            export_file = argv[++i];
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            window = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            trials = atoi(argv[++i]);
+        else
+            in_file = argv[i];
+    }
+
+    AllocMethod methods[] = {FIRST_APPROACH, BEST_APPROACH, WORST_APPROACH, NEXT_APPROACH, BUDDY_APPROACH, TLSF_APPROACH};
+    const int num_methods = sizeof(methods) / sizeof(methods[0]);
+    Stats perf_stats[sizeof(methods) / sizeof(methods[0])] = {0};
+    StrategyRun runs[sizeof(methods) / sizeof(methods[0])] = {0};
+
+    Script script = {0};
+    GenConfig gen = {0};
+    MappedTrace trace = {0};
+    Proc *procs = NULL;
+    int num_procs = 0;
+    int mem_capacity = 0;
+    RunMode mode = RUN_INTERACTIVE;
+    Exporter exporter = {0};
+
+    if (gen_spec != NULL)
+    {
+        if (!parse_gen_spec(gen_spec, &gen))
+            return EXIT_FAILURE;
+
+        if (gen_out != NULL)
+        {
+            if (!write_workload(gen_out, &gen))
+                return EXIT_FAILURE;
+            printf("Wrote %d generated processes to %s\n", gen.count, gen_out);
+            return EXIT_SUCCESS;
+        }
+
+        mode = RUN_GENERATED;
+        mem_capacity = gen.capacity;
+
+        printf("\n===== GENERATED WORKLOAD SIMULATION =====\n\n");
+        printf("Workload: %d processes, %s sizes in [%d, %d] KB, seed %llu\n",
+               gen.count, size_dist_name(gen.dist), gen.min_size, gen.max_size, gen.seed);
+        printf("Arrivals: Poisson, %g per time unit; mean lifetime %g\n", gen.arrival_rate, gen.mean_life);
+        printf("Memory size: %d KB\n", mem_capacity);
+
+        if (trials > 0)
+        {
+            if (export_file != NULL && !exporter_open(&exporter, export_file, gen_spec))
+                return EXIT_FAILURE;
+            bool swept = run_sweep(&gen, methods, num_methods, trials, compact, (export_file != NULL) ? &exporter : NULL);
+            exporter_close(&exporter);
+            return swept ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    else if (trials > 0)
+    {
+        fprintf(stderr, "Error: -n needs a generated workload (-g)\n");
+        return EXIT_FAILURE;
+    }
+    else if (script_file != NULL)
+    {
+        mode = RUN_SCRIPT;
+
+        if (!load_script(script_file, &script))
+        {
+            fprintf(stderr, "Failed to read operations from script file.\n");
+            return EXIT_FAILURE;
+        }
+        mem_capacity = script.capacity;
+
+        printf("\n===== SCRIPTED MEMORY ALLOCATION RUN =====\n\n");
+        printf("Script file: %s\n", script_file);
+        printf("Memory size: %d KB\n", mem_capacity);
+        printf("Number of operations: %lld\n", script.num_ops);
+    }
+    else if (bin_out != NULL)
+    {
+        if (!convert_trace(in_file, bin_out))
+            return EXIT_FAILURE;
+        printf("Converted %s to binary trace %s\n", in_file, bin_out);
+        return EXIT_SUCCESS;
+    }
+    else if (event_mode && is_binary_trace(in_file))
+    {
+        if (!map_trace(in_file, &trace))
+            return EXIT_FAILURE;
+        mode = RUN_MAPPED;
+        mem_capacity = trace.header->capacity;
+
+        printf("\n===== STATIC MEMORY ALLOCATION SIMULATION =====\n\n");
+        printf("Input file: %s (binary trace)\n", in_file);
+        printf("Memory size: %d KB\n", mem_capacity);
+        printf("Number of processes: %lld\n", trace.header->count);
+    }
+    else if (event_mode)
+    {
+        TextFeed probe;
+        if (window < 1)
+            window = 1;
+        Proc first;
+        if (!text_feed_open(&probe, in_file, 1, false))
+            return EXIT_FAILURE;
+        mem_capacity = probe.capacity;
+        bool any = text_feed_next(&probe, &first);
+        text_feed_close(&probe);
+        if (!any)
+        {
+            fprintf(stderr, "Warning: No valid processes found in input file\n");
+            fprintf(stderr, "Failed to read processes from input file.\n");
+            return EXIT_FAILURE;
+        }
+        mode = RUN_STREAM;
+
+        printf("\n===== STATIC MEMORY ALLOCATION SIMULATION =====\n\n");
+        printf("Input file: %s (streamed, reorder window %d)\n", in_file, window);
+        printf("Memory size: %d KB\n", mem_capacity);
+    }
+    else
+    {
+        long long bytes_read = 0;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool loaded = is_binary_trace(in_file) ? load_procs_from_trace(in_file, &procs, &num_procs, &mem_capacity, &bytes_read)
+                                               : load_procs_from_file(in_file, &procs, &num_procs, &mem_capacity, &bytes_read);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        if (!loaded)
+        {
+            fprintf(stderr, "Failed to read processes from input file.\n");
+            return EXIT_FAILURE;
+        }
+        double load_secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        printf("\n===== STATIC MEMORY ALLOCATION SIMULATION =====\n\n");
+        printf("Input file: %s\n", in_file);
+        printf("Memory size: %d KB\n", mem_capacity);
+        printf("Number of processes: %d\n", num_procs);
+        printf("Parsed %.2f MB in %.3f s (%.1f MB/s)\n\n", bytes_read / 1e6, load_secs,
+               (load_secs > 0.0) ? bytes_read / 1e6 / load_secs : 0.0);
+
+        printf("-------------------------------------------------\n");
+        printf("Processes Loaded:\n");
+        printf("%-10s %-10s\n", "ProcessID", "Size (KB)");
+        printf("-------------------------------------------------\n");
+        for (int i = 0; i < num_procs; i++)
+        {
+            printf("%-10d %-10d\n", procs[i].id, procs[i].req_size);
+        }
+        printf("\n");
+    }
+
+    if (parallel && mode == RUN_INTERACTIVE)
+    {
+        fprintf(stderr, "Warning: -j needs -e, -t or -g; running strategies one at a time\n");
+        parallel = false;
+    }
+
+    if (export_file != NULL &&
+        !exporter_open(&exporter, export_file, (gen_spec != NULL) ? gen_spec : (script_file != NULL) ? script_file : in_file))
+    {
+        unmap_trace(&trace);
+        free(script.ops);
+        free(procs);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < num_methods; i++)
+    {
+        runs[i].mode = mode;
+        runs[i].method = methods[i];
+        runs[i].capacity = mem_capacity;
+        runs[i].verbosity = (mode == RUN_SCRIPT) ? VERBOSITY_OFF : verbosity;
+        runs[i].procs = procs;
+        runs[i].num_procs = num_procs;
+        runs[i].script = &script;
+        runs[i].gen = &gen;
+        runs[i].trace = &trace;
+        runs[i].in_file = in_file;
+        runs[i].window = window;
+        runs[i].warn = (i == 0);
+        runs[i].series_prefix = series_prefix;
+        runs[i].compact = compact;
+        runs[i].exporter = (export_file != NULL) ? &exporter : NULL;
+        runs[i].stats = &perf_stats[i];
+        runs[i].out = stdout;
+    }
+
+    bool ok = true;
+
+    if (parallel)
+    {
+        pthread_t threads[sizeof(methods) / sizeof(methods[0])];
+        bool started[sizeof(methods) / sizeof(methods[0])] = {false};
+
+        for (int i = 0; i < num_methods; i++)
+        {
+            runs[i].out = open_memstream(&runs[i].out_buf, &runs[i].out_len);
+            if (runs[i].out == NULL)
+                runs[i].out = stdout;
+            else
+                started[i] = (pthread_create(&threads[i], NULL, run_strategy, &runs[i]) == 0);
+        }
+
+        for (int i = 0; i < num_methods; i++)
+        {
+            if (started[i])
+                pthread_join(threads[i], NULL);
+            else
+                run_strategy(&runs[i]);
+
+            if (runs[i].out != stdout)
+            {
+                fclose(runs[i].out);
+                fwrite(runs[i].out_buf, 1, runs[i].out_len, stdout);
+                free(runs[i].out_buf);
+            }
+            ok = ok && runs[i].ok;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < num_methods && ok; i++)
+        {
+            run_strategy(&runs[i]);
+            ok = runs[i].ok;
+        }
+    }
+
+    if (ok)
+        print_summary(methods, perf_stats, num_methods);
+    else
+        fprintf(stderr, "Error: Out of memory setting up simulation.\n");
+
+    exporter_close(&exporter);
+    unmap_trace(&trace);
+    free(script.ops);
+    free(procs);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void *run_strategy(void *arg)
+{
+    StrategyRun *run = arg;
+    MemMgr mgr;
+
+    run->ok = false;
+    if (!init_mem_mgr(&mgr, run->method, run->capacity))
+        return NULL;
+    mgr.verbosity = run->verbosity;
+    mgr.compact_on_fail = run->compact;
+    mgr.out = run->out;
+
+    if (run->series_prefix != NULL)
+    {
+        char path[MAX_LINE_LEN];
+        snprintf(path, sizeof(path), "%s.%s.csv", run->series_prefix, method_title(run->method));
+        if (!usage_ring_spill_to(&mgr, path))
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    switch (run->mode)
+    {
+    case RUN_SCRIPT:
+        run_script(&mgr, run->script, run->stats);
+        break;
+    case RUN_MAPPED:
+    {
+        MappedFeed feed = {run->trace->records, run->trace->header->count, 0};
+        if (!run_event_sim(&mgr, mapped_feed_next, &feed, run->stats))
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+        break;
+    }
+    case RUN_STREAM:
+    {
+        TextFeed feed;
+        if (!text_feed_open(&feed, run->in_file, run->window, run->warn))
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+        bool finished = run_event_sim(&mgr, text_feed_next, &feed, run->stats);
+        text_feed_close(&feed);
+        if (!finished)
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+        break;
+    }
+    case RUN_GENERATED:
+    {
+        GenFeed feed;
+        gen_feed_init(&feed, run->gen);
+        if (!run_event_sim(&mgr, gen_feed_next, &feed, run->stats))
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+        break;
+    }
+    case RUN_INTERACTIVE:
+    {
+        Proc *sim_procs = malloc(sizeof(Proc) * (run->num_procs + 1));
+        if (sim_procs == NULL)
+        {
+            destroy_mem_mgr(&mgr);
+            return NULL;
+        }
+
+        memcpy(sim_procs, run->procs, sizeof(Proc) * run->num_procs);
+        run_sim(&mgr, run->method, sim_procs, run->num_procs, run->stats);
+        free(sim_procs);
+        break;
+    }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    finish_stats(&mgr, run->stats);
+
+    if (run->exporter != NULL)
+    {
+        static const char *const mode_names[] = {"interactive", "script", "generated", "mapped", "stream"};
+        double elapsed = (run->mode == RUN_INTERACTIVE) ? -1.0 : (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        export_run(run->exporter, &mgr, mode_names[run->mode], (run->mode == RUN_GENERATED) ? run->gen->seed : 0,
+                   run->stats, elapsed);
+    }
+
+    destroy_mem_mgr(&mgr);
+    run->ok = true;
+    return NULL;
+}
+
+void print_summary(const AllocMethod methods[], const Stats stats[], int num_methods)
+{
+    printf("\n=== Summary of Allocation Methods ===\n");
+    printf("%-10s %-15s %-15s %-15s %-15s\n", "Strategy", "Success Rate", "Fragmentation", "Block Count", "Internal Frag");
+    printf("--------------------------------------------------------------------------\n");
+
+    for (int i = 0; i < num_methods; i++)
+    {
+        double success_rate =
+            (stats[i].alloc_tries > 0) ? ((double)stats[i].alloc_success / stats[i].alloc_tries * 100.0) : 0.0;
+
+        char success_str[20], frag_str[20], int_frag_str[20];
+        sprintf(success_str, "%.1f%%", success_rate);
+        sprintf(frag_str, "%.1f%%", stats[i].frag_percent);
+        sprintf(int_frag_str, "%.1f%%", stats[i].int_frag_percent);
+
+        printf("%-10s %-15s %-15s %-15d %-15s\n",
+               method_title(methods[i]),
+               success_str,
+               frag_str,
+               stats[i].ext_frag,
+               int_frag_str);
+    }
+
+    printf("\n=== Operation Latency (ns) ===\n");
+    printf("%-10s %-9s %-9s %-9s %-9s %-9s %-9s %-9s %-9s\n", "Strategy",
+           "Alloc p50", "p99", "p99.9", "max", "Free p50", "p99", "p99.9", "max");
+    printf("------------------------------------------------------------------------------------------\n");
+
+    for (int i = 0; i < num_methods; i++)
+    {
+        printf("%-10s %-9.0f %-9.0f %-9.0f %-9.0f %-9.0f %-9.0f %-9.0f %-9.0f\n", method_title(methods[i]),
+               stats[i].alloc_ns[0], stats[i].alloc_ns[1], stats[i].alloc_ns[2], stats[i].alloc_ns[3],
+               stats[i].free_ns[0], stats[i].free_ns[1], stats[i].free_ns[2], stats[i].free_ns[3]);
+    }
+
+    bool compacted = false;
+    for (int i = 0; i < num_methods; i++)
+    {
+        compacted = compacted || stats[i].compactions > 0;
+    }
+    if (!compacted)
+        return;
+
+    printf("\n=== Compaction ===\n");
+    printf("%-10s %-15s %-15s %-15s\n", "Strategy", "Passes", "KB Moved", "Time (ms)");
+    printf("--------------------------------------------------------------------------\n");
+
+    for (int i = 0; i < num_methods; i++)
+    {
+        printf("%-10s %-15d %-15lld %-15.3f\n", method_title(methods[i]), stats[i].compactions,
+               stats[i].compact_moved, stats[i].compact_ms);
+    }
+}
+
+bool init_mem_mgr(MemMgr *mgr, AllocMethod method, int capacity)
+{
+    mgr->full_size = capacity;
+    mgr->avail_size = mgr->full_size;
+    mgr->num_blocks = 0;
+    mgr->method = method;
+    mgr->verbosity = VERBOSITY_TEXT;
+    mgr->out = stdout;
+
+    mgr->spare_head = -1;
+    mgr->block_chunks = NULL;
+    mgr->num_chunks = 0;
+    mgr->chunk_slots = 0;
+    mgr->block_cap = 0;
+    mgr->free_heap = NULL;
+
+    mgr->size_root = -1;
+    mgr->addr_root = -1;
+    mgr->tree_seed = 2463534242u;
+    mgr->clocked = false;
+    mgr->now = 0;
+    memset(&mgr->alloc_lat, 0, sizeof(LatencyHist));
+    memset(&mgr->free_lat, 0, sizeof(LatencyHist));
+    mgr->compact_on_fail = false;
+    mgr->compactions = 0;
+    mgr->compact_moved = 0;
+    mgr->compact_ticks = 0;
+    if (!usage_ring_init(&mgr->series))
+    {
+        return false;
+    }
+    if (!event_log_init(&mgr->log))
+    {
+        usage_ring_close(&mgr->series);
+        return false;
+    }
+
+    mgr->heap_len = 0;
+    mgr->rover_addr = 0;
+    mgr->addr_indexed = (method != BUDDY_APPROACH && method != TLSF_APPROACH);
+    mgr->order_mask = 0;
+    for (int i = 0; i < BUDDY_ORDERS; i++)
+    {
+        mgr->order_heads[i] = -1;
+    }
+    mgr->free_blocks = 0;
+    memset(mgr->free_hist, 0, sizeof(mgr->free_hist));
+    mgr->int_frag = 0;
+    mgr->tlsf_fl_map = 0;
+    for (int fl = 0; fl < TLSF_FL_COUNT; fl++)
+    {
+        mgr->tlsf_sl_map[fl] = 0;
+        for (int sl = 0; sl < TLSF_SL_COUNT; sl++)
+        {
+            mgr->tlsf_heads[fl][sl] = -1;
+        }
+    }
+
+    mgr->head = -1;
+    int tail = -1;
+    int addr = 0;
+
+    while (addr < mgr->full_size || mgr->head == -1)
+    {
+        int size = mgr->full_size - addr;
+
+        if (method == BUDDY_APPROACH && size > 0)
+        {
+            size = 1 << (31 - __builtin_clz((unsigned int)size));
+        }
+
+        int blk = block_alloc(mgr);
+        if (blk == -1)
+        {
+            destroy_mem_mgr(mgr);
+            return false;
+        }
+
+        MemBlock *b = block_at(mgr, blk);
+        b->begin_addr = addr;
+        b->chunk_size = size;
+        b->used_size = 0;
+        b->available = true;
+        b->proc_id = -1;
+        b->prev = tail;
+        b->next = -1;
+        if (tail != -1)
+            block_at(mgr, tail)->next = blk;
+        else
+            mgr->head = blk;
+        tail = blk;
+
+        free_index_insert(mgr, blk);
+        addr_tree_insert(mgr, blk);
+        addr += size;
+    }
+    return true;
+}
+
+bool usage_ring_init(UsageRing *ring)
+{
+    memset(ring, 0, sizeof(UsageRing));
+    ring->buf = malloc(sizeof(UsageSample) * USAGE_RING_SIZE);
+    return ring->buf != NULL;
+}
+
+static void usage_ring_spill(UsageRing *ring, long long upto)
+{
+    for (; ring->spilled < upto; ring->spilled++)
+    {
+        const UsageSample *sample = &ring->buf[ring->spilled & (USAGE_RING_SIZE - 1)];
+        fprintf(ring->spill, "%lld,%lld,%.4f,%d,%d\n", ring->spilled, sample->time, sample->util,
+                sample->free_blocks, sample->largest);
+    }
+}
+
+bool usage_ring_spill_to(MemMgr *mgr, const char *filename)
+{
+    mgr->series.spill = fopen(filename, "w");
+    if (mgr->series.spill == NULL)
+    {
+        fprintf(stderr, "Error: Could not open series file '%s'\n", filename);
+        return false;
+    }
+    fprintf(mgr->series.spill, "op,time,utilization,free_blocks,largest_free\n");
+    return true;
+}
+
+void usage_ring_close(UsageRing *ring)
+{
+    if (ring->spill != NULL)
+    {
+        usage_ring_spill(ring, ring->count);
+        fclose(ring->spill);
+        ring->spill = NULL;
+    }
+    free(ring->buf);
+    ring->buf = NULL;
+}
+
+void record_usage(MemMgr *mgr)
+{
+    UsageRing *ring = &mgr->series;
+    long long now = mgr->clocked ? mgr->now : ring->count;
+    double util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+
+    if (ring->count == 0)
+        ring->start_time = now;
+    else
+        ring->area += ring->last_util * (now - ring->last_time);
+    ring->last_time = now;
+    ring->last_util = util;
+
+    UsageSample *sample = &ring->buf[ring->count & (USAGE_RING_SIZE - 1)];
+    sample->time = now;
+    sample->util = (float)util;
+    sample->free_blocks = mgr->free_blocks;
+    sample->largest = largest_free_block(mgr);
+
+    ring->count++;
+    if (ring->spill != NULL && (ring->count & (USAGE_RING_SIZE - 1)) == 0)
+        usage_ring_spill(ring, ring->count);
+}
+
+/* each operation's utilization holds until the next one; the last holds for one op (or until mgr->now) */
+double usage_time_average(MemMgr *mgr)
+{
+    UsageRing *ring = &mgr->series;
+    if (ring->count == 0)
+        return 0.0;
+
+    long long end = mgr->clocked ? mgr->now : ring->count;
+    long long span = end - ring->start_time;
+    if (span <= 0)
+        return ring->last_util;
+    return (ring->area + ring->last_util * (end - ring->last_time)) / span;
+}
+
+bool event_log_init(EventLog *log)
+{
+    memset(log, 0, sizeof(EventLog));
+    log->buf = malloc(sizeof(LogRecord) * EVENT_LOG_SIZE);
+    return log->buf != NULL;
+}
+
+static void format_event(FILE *out, const LogRecord *rec)
+{
+    const int *a = rec->args;
+    switch (rec->kind)
+    {
+    case LOG_ARRIVE:
+        fprintf(out, "[t=%lld] P%d arrives (%d KB): placed at %d\n", rec->time, a[0], a[1], a[2]);
+        break;
+    case LOG_ARRIVE_FAILED:
+        fprintf(out, "[t=%lld] P%d arrives (%d KB): FAILED\n", rec->time, a[0], a[1]);
+        break;
+    case LOG_DEPART:
+        fprintf(out, "[t=%lld] P%d departs\n", rec->time, a[0]);
+        break;
+    case LOG_RELEASE:
+        fprintf(out, "\nCoalescing Process: Checking for adjacent free blocks after P%d termination\n", a[0]);
+        break;
+    case LOG_COALESCE:
+        fprintf(out, "  Coalescing blocks at addresses %d and %d (sizes: %d KB + %d KB = %d KB)\n",
+                a[0], a[1], a[2], a[3], a[2] + a[3]);
+        break;
+    case LOG_MERGED:
+        if (a[0] == 0)
+            fprintf(out, "  No adjacent free blocks found for coalescing\n");
+        else
+            fprintf(out, "  Completed %d coalescing operations\n", a[0]);
+        break;
+    case LOG_COMPACT:
+        fprintf(out, "  Compaction: moved %d KB in %d blocks (%d us)\n", a[0], a[1], a[2]);
+        break;
+    case LOG_PLACED:
+        fprintf(out, a[1] ? "P%d " : "P%d(FAILED) ", a[0]);
+        break;
+    }
+}
+
+/* text mode formats immediately; buffered mode keeps the newest EVENT_LOG_SIZE records until a flush */
+void log_event(MemMgr *mgr, LogKind kind, int a, int b, int c, int d)
+{
+    EventLog *log = &mgr->log;
+    LogRecord *rec = &log->buf[log->count & (EVENT_LOG_SIZE - 1)];
+    rec->time = mgr->now;
+    rec->kind = kind;
+    rec->args[0] = a;
+    rec->args[1] = b;
+    rec->args[2] = c;
+    rec->args[3] = d;
+
+    if (mgr->verbosity == VERBOSITY_TEXT)
+    {
+        format_event(mgr->out, rec);
+        log->flushed++;
+    }
+    log->count++;
+}
+
+void event_log_flush(MemMgr *mgr)
+{
+    EventLog *log = &mgr->log;
+    if (log->buf == NULL || log->flushed == log->count)
+        return;
+
+    if (log->count - log->flushed > EVENT_LOG_SIZE)
+    {
+        fprintf(mgr->out, "\n[%lld earlier events dropped]\n", log->count - log->flushed - EVENT_LOG_SIZE);
+        log->flushed = log->count - EVENT_LOG_SIZE;
+    }
+    for (; log->flushed < log->count; log->flushed++)
+    {
+        format_event(mgr->out, &log->buf[log->flushed & (EVENT_LOG_SIZE - 1)]);
+    }
+}
+
+static pthread_once_t tick_calibration = PTHREAD_ONCE_INIT;
+static double tick_rate = 1.0;
+
+static inline unsigned long long read_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void calibrate_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long first = read_ticks();
+    double ns;
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ns = (now.tv_sec - start.tv_sec) * 1e9 + (now.tv_nsec - start.tv_nsec);
+    } while (ns < 10e6);
+    tick_rate = (read_ticks() - first) / ns;
+#endif
+}
+
+double ticks_per_ns(void)
+{
+    pthread_once(&tick_calibration, calibrate_ticks);
+    return tick_rate;
+}
+
+/* HDR-style buckets: exact below LAT_SUB_COUNT, then LAT_SUB_COUNT linear steps per power of two */
+static inline int latency_bucket(unsigned long long ticks)
+{
+    if (ticks < LAT_SUB_COUNT)
+        return (int)ticks;
+    int exp = 63 - __builtin_clzll(ticks);
+    return (exp - LAT_SUB_BITS + 1) * LAT_SUB_COUNT + (int)((ticks >> (exp - LAT_SUB_BITS)) & (LAT_SUB_COUNT - 1));
+}
+
+static unsigned long long latency_bucket_top(int bucket)
+{
+    if (bucket < LAT_SUB_COUNT)
+        return bucket;
+    int exp = bucket / LAT_SUB_COUNT + LAT_SUB_BITS - 1;
+    unsigned long long step = 1ULL << (exp - LAT_SUB_BITS);
+    return (LAT_SUB_COUNT + bucket % LAT_SUB_COUNT) * step + step - 1;
+}
+
+static inline void latency_record(LatencyHist *hist, unsigned long long ticks)
+{
+    hist->counts[latency_bucket(ticks)]++;
+    hist->total++;
+    if (ticks > hist->max)
+        hist->max = ticks;
+}
+
+/* p50, p99, p99.9 and max, in nanoseconds */
+void latency_quantiles(const LatencyHist *hist, double out_ns[LAT_QUANTILES])
+{
+    static const double quantiles[LAT_QUANTILES - 1] = {0.50, 0.99, 0.999};
+    double rate = ticks_per_ns();
+
+    for (int q = 0; q < LAT_QUANTILES; q++)
+    {
+        out_ns[q] = 0.0;
+    }
+    if (hist->total == 0)
+        return;
+
+    int bucket = 0;
+    long long seen = 0;
+    for (int q = 0; q < LAT_QUANTILES - 1; q++)
+    {
+        long long rank = (long long)ceil(quantiles[q] * hist->total);
+        while (seen + hist->counts[bucket] < rank)
+        {
+            seen += hist->counts[bucket++];
+        }
+        unsigned long long top = latency_bucket_top(bucket);
+        out_ns[q] = ((top < hist->max) ? top : hist->max) / rate;
+    }
+    out_ns[LAT_QUANTILES - 1] = hist->max / rate;
+}
+
+void destroy_mem_mgr(MemMgr *mgr)
+{
+    for (int i = 0; i < mgr->num_chunks; i++)
+    {
+        free(mgr->block_chunks[i]);
+    }
+    free(mgr->block_chunks);
+    free(mgr->free_heap);
+    event_log_flush(mgr);
+    free(mgr->log.buf);
+    mgr->log.buf = NULL;
+    usage_ring_close(&mgr->series);
+
+    mgr->block_chunks = NULL;
+    mgr->free_heap = NULL;
+    mgr->num_chunks = 0;
+    mgr->chunk_slots = 0;
+    mgr->block_cap = 0;
+}
+
+/* splits the free block block_idx down to the request and hands it to proc */
+static bool claim_block(MemMgr *mgr, Proc *proc, int block_idx)
+{
+    if (mgr->method == BUDDY_APPROACH)
+    {
+        block_idx = buddy_split(mgr, block_idx, proc->req_size);
+        if (block_idx == -1)
+        {
+            return false;
+        }
+    }
+    else if (block_at(mgr, block_idx)->chunk_size > proc->req_size + 10)
+    {
+        block_idx = carve_block(mgr, block_idx, proc->req_size);
+        if (block_idx == -1)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        free_index_remove(mgr, block_idx);
+    }
+
+    block_at(mgr, block_idx)->available = false;
+    block_at(mgr, block_idx)->proc_id = proc->id;
+    block_at(mgr, block_idx)->used_size = proc->req_size;
+    addr_tree_update(mgr, block_idx);
+    mgr->rover_addr = block_at(mgr, block_idx)->begin_addr + block_at(mgr, block_idx)->chunk_size;
+    proc->handle = make_handle(mgr, block_idx);
+    proc->status = PROC_ACTIVE;
+    mgr->avail_size -= block_at(mgr, block_idx)->chunk_size;
+    mgr->int_frag += block_at(mgr, block_idx)->chunk_size - proc->req_size;
+
+    return true;
+}
+
+static bool place_proc(MemMgr *mgr, Proc *proc)
+{
+    if (proc->req_size > mgr->avail_size)
+    {
+        return false;
+    }
+
+    if (proc->req_size > largest_free_block(mgr))
+    {
+        return false;
+    }
+
+    int block_idx = -1;
+
+    switch (mgr->method)
+    {
+    case FIRST_APPROACH:
+        block_idx = find_first_fit(mgr, proc->req_size);
+        break;
+    case BEST_APPROACH:
+        block_idx = find_best_fit(mgr, proc->req_size);
+        break;
+    case WORST_APPROACH:
+        block_idx = find_worst_fit(mgr, proc->req_size);
+        break;
+    case NEXT_APPROACH:
+        block_idx = find_next_fit(mgr, proc->req_size);
+        break;
+    case BUDDY_APPROACH:
+        block_idx = find_buddy_fit(mgr, proc->req_size);
+        break;
+    case TLSF_APPROACH:
+        block_idx = find_tlsf_fit(mgr, proc->req_size);
+        break;
+    }
+
+    if (block_idx == -1)
+    {
+        return false;
+    }
+    return claim_block(mgr, proc, block_idx);
+}
+
+bool allocate_mem(MemMgr *mgr, Proc *proc)
+{
+    unsigned long long start = read_ticks();
+    bool placed = place_proc(mgr, proc);
+    latency_record(&mgr->alloc_lat, read_ticks() - start);
+    record_usage(mgr);
+    return placed;
+}
+
+static void coalesce_with_next(MemMgr *mgr, int blk)
+{
+    int nxt = block_at(mgr, blk)->next;
+
+    if (mgr->verbosity != VERBOSITY_OFF)
+        log_event(mgr, LOG_COALESCE,
+                  block_at(mgr, blk)->begin_addr,
+                  block_at(mgr, nxt)->begin_addr,
+                  block_at(mgr, blk)->chunk_size,
+                  block_at(mgr, nxt)->chunk_size);
+
+    absorb_next_block(mgr, blk);
+}
+
+static int buddy_coalesce(MemMgr *mgr, int blk)
+{
+    int merge_ops = 0;
+
+    for (;;)
+    {
+        MemBlock *b = block_at(mgr, blk);
+        int buddy_addr = b->begin_addr ^ b->chunk_size;
+        int buddy = (buddy_addr > b->begin_addr) ? b->next : b->prev;
+
+        if (buddy == -1 || !block_at(mgr, buddy)->available ||
+            block_at(mgr, buddy)->begin_addr != buddy_addr ||
+            block_at(mgr, buddy)->chunk_size != b->chunk_size)
+        {
+            break;
+        }
+
+        if (buddy_addr > b->begin_addr)
+        {
+            coalesce_with_next(mgr, blk);
+        }
+        else
+        {
+            coalesce_with_next(mgr, buddy);
+            blk = buddy;
+        }
+        merge_ops++;
+    }
+    return merge_ops;
+}
+
+static int release_block(MemMgr *mgr, int idx)
+{
+    block_at(mgr, idx)->gen++;
+    block_at(mgr, idx)->available = true;
+    block_at(mgr, idx)->proc_id = -1;
+    mgr->avail_size += block_at(mgr, idx)->chunk_size;
+    mgr->int_frag -= block_at(mgr, idx)->chunk_size - block_at(mgr, idx)->used_size;
+    free_index_insert(mgr, idx);
+    addr_tree_update(mgr, idx);
+
+    if (mgr->method == BUDDY_APPROACH)
+    {
+        return buddy_coalesce(mgr, idx);
+    }
+
+    int merge_ops = 0;
+
+    /* prev/next act as the block's boundary tags: only these two can merge */
+    int prev = block_at(mgr, idx)->prev;
+    if (prev != -1 && block_at(mgr, prev)->available)
+    {
+        coalesce_with_next(mgr, prev);
+        idx = prev;
+        merge_ops++;
+    }
+
+    int next = block_at(mgr, idx)->next;
+    if (next != -1 && block_at(mgr, next)->available)
+    {
+        coalesce_with_next(mgr, idx);
+        merge_ops++;
+    }
+    return merge_ops;
+}
+
+void free_mem(MemMgr *mgr, Proc *proc)
+{
+    int idx = resolve_handle(mgr, proc->handle);
+    if (idx == -1)
+    {
+        return;
+    }
+
+    proc->status = PROC_DONE;
+    proc->handle = NO_BLOCK;
+
+    if (mgr->verbosity != VERBOSITY_OFF)
+        log_event(mgr, LOG_RELEASE, proc->id, 0, 0, 0);
+
+    unsigned long long start = read_ticks();
+    int merge_ops = release_block(mgr, idx);
+    latency_record(&mgr->free_lat, read_ticks() - start);
+    record_usage(mgr);
+
+    if (mgr->verbosity != VERBOSITY_OFF)
+        log_event(mgr, LOG_MERGED, merge_ops, 0, 0, 0);
+}
+
+bool can_compact(MemMgr *mgr, const Proc *proc)
+{
+    return mgr->compact_on_fail && mgr->method != BUDDY_APPROACH &&
+           mgr->free_blocks > 1 && proc->req_size <= mgr->avail_size;
+}
+
+/*
+ * Slides every allocated block down to the lowest free address, keeping
+ * address order, and leaves one free block at the top. Blocks keep their
+ * slot and generation, so every Proc handle still resolves to its block.
+ * Returns the KB moved.
+ */
+long long compact_mem(MemMgr *mgr)
+{
+    unsigned long long start = read_ticks();
+    long long moved = 0;
+    int moved_blocks = 0;
+    int addr = 0;
+    int tail = -1;
+
+    int blk = mgr->head;
+    mgr->head = -1;
+    while (blk != -1)
+    {
+        MemBlock *b = block_at(mgr, blk);
+        int next = b->next;
+
+        if (b->available)
+        {
+            free_index_remove(mgr, blk);
+            addr_tree_remove(mgr, blk);
+            block_release(mgr, blk);
+        }
+        else
+        {
+            /* everything before this block already sits below it, so the address treap stays ordered */
+            if (b->begin_addr != addr)
+            {
+                b->begin_addr = addr;
+                moved += b->used_size;
+                moved_blocks++;
+            }
+            b->prev = tail;
+            if (tail != -1)
+                block_at(mgr, tail)->next = blk;
+            else
+                mgr->head = blk;
+            tail = blk;
+            addr += b->chunk_size;
+        }
+        blk = next;
+    }
+
+    if (tail != -1)
+        block_at(mgr, tail)->next = -1;
+
+    if (addr < mgr->full_size)
+    {
+        int top = block_alloc(mgr);
+        MemBlock *t = block_at(mgr, top);
+        t->begin_addr = addr;
+        t->chunk_size = mgr->full_size - addr;
+        t->used_size = 0;
+        t->available = true;
+        t->proc_id = -1;
+        t->prev = tail;
+        t->next = -1;
+        if (tail != -1)
+            block_at(mgr, tail)->next = top;
+        else
+            mgr->head = top;
+
+        free_index_insert(mgr, top);
+        addr_tree_insert(mgr, top);
+    }
+    mgr->rover_addr = addr;
+
+    unsigned long long ticks = read_ticks() - start;
+    mgr->compactions++;
+    mgr->compact_moved += moved;
+    mgr->compact_ticks += ticks;
+
+    if (mgr->verbosity != VERBOSITY_OFF)
+        log_event(mgr, LOG_COMPACT, (int)moved, moved_blocks, (int)(ticks / ticks_per_ns() / 1000.0), 0);
+    return moved;
+}
+
+/* the failed try, the compaction and the retry are one request, so they are timed as one */
+/*
+ * Compaction leaves at most one free block. TLSF's rounded search skips
+ * it when it lies in the request's own size class, so test it directly.
+ */
+static bool place_after_compact(MemMgr *mgr, Proc *proc)
+{
+    if (mgr->method != TLSF_APPROACH || mgr->free_blocks != 1)
+        return place_proc(mgr, proc);
+
+    int fl = __builtin_ctz(mgr->tlsf_fl_map);
+    int blk = mgr->tlsf_heads[fl][__builtin_ctz(mgr->tlsf_sl_map[fl])];
+    return block_at(mgr, blk)->chunk_size >= proc->req_size && claim_block(mgr, proc, blk);
+}
+
+bool allocate_or_compact(MemMgr *mgr, Proc *proc)
+{
+    unsigned long long start = read_ticks();
+    bool placed = place_proc(mgr, proc);
+    if (!placed && can_compact(mgr, proc))
+    {
+        compact_mem(mgr);
+        placed = place_after_compact(mgr, proc);
+    }
+    latency_record(&mgr->alloc_lat, read_ticks() - start);
+    record_usage(mgr);
+    return placed;
+}
+
+void finish_stats(MemMgr *mgr, Stats *stats)
+{
+    latency_quantiles(&mgr->alloc_lat, stats->alloc_ns);
+    latency_quantiles(&mgr->free_lat, stats->free_ns);
+    stats->compactions = mgr->compactions;
+    stats->compact_moved = mgr->compact_moved;
+    stats->compact_ms = mgr->compact_ticks / ticks_per_ns() / 1e6;
+}
+
+bool line_reader_open(LineReader *reader, const char *filename)
+{
+    memset(reader, 0, sizeof(LineReader));
+
+    reader->in_file = fopen(filename, "r");
+    if (reader->in_file == NULL)
+    {
+        fprintf(stderr, "Error: Could not open input file '%s'\n", filename);
+        return false;
+    }
+
+    reader->buf = malloc(READ_BLOCK_SIZE);
+    if (reader->buf == NULL)
+    {
+        fprintf(stderr, "Error: Out of memory allocating the read buffer\n");
+        fclose(reader->in_file);
+        return false;
+    }
+    reader->cap = READ_BLOCK_SIZE;
+    return true;
+}
+
+void line_reader_close(LineReader *reader)
+{
+    if (reader->in_file != NULL)
+        fclose(reader->in_file);
+    free(reader->buf);
+    reader->in_file = NULL;
+    reader->buf = NULL;
+}
+
+/* hands out the next line (without its '\n') in place; valid until the next call */
+bool line_reader_next(LineReader *reader, const char **line, size_t *len)
+{
+    while (true)
+    {
+        char *start = reader->buf + reader->start;
+        char *nl = memchr(start, '\n', reader->end - reader->start);
+        if (nl != NULL)
+        {
+            *line = start;
+            *len = nl - start;
+            reader->start += *len + 1;
+            return true;
+        }
+
+        size_t tail = reader->end - reader->start;
+        if (reader->eof)
+        {
+            if (tail == 0)
+                return false;
+            *line = start;
+            *len = tail;
+            reader->start = reader->end;
+            return true;
+        }
+
+        /* a single line fills the buffer: double it rather than split the line */
+        if (tail == reader->cap)
+        {
+            char *grown = realloc(reader->buf, reader->cap * 2);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "Error: Out of memory reading a %zu-byte line\n", tail);
+                return false;
+            }
+            reader->buf = grown;
+            reader->cap *= 2;
+            start = reader->buf;
+        }
+
+        memmove(reader->buf, start, tail);
+        reader->start = 0;
+        reader->end = tail;
+
+        size_t got = fread(reader->buf + tail, 1, reader->cap - tail, reader->in_file);
+        reader->end += got;
+        reader->bytes += got;
+        if (got == 0)
+            reader->eof = true;
+    }
+}
+
+static bool scan_int(const char **pos, const char *end, int *out)
+{
+    const char *p = *pos;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+        p++;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+
+    long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        value = value * 10 + (*p++ - '0');
+        if (value > (long long)INT_MAX + 1)
+            return false;
+    }
+    if (negative)
+        value = -value;
+    if (value > INT_MAX)
+        return false;
+
+    *out = (int)value;
+    *pos = p;
+    return true;
+}
+
+bool parse_capacity_line(const char *line, size_t len, int *capacity)
+{
+    return scan_int(&line, line + len, capacity) && *capacity > 0;
+}
+
+bool parse_proc_line(const char *line, size_t len, int line_num, Proc *proc, bool warn)
+{
+    if (len == 0 || line[0] == '#')
+    {
+        return false;
+    }
+
+    const char *pos = line;
+    int values[4] = {0, 0, 0, 10};
+    int fields = 0;
+    while (fields < 4 && scan_int(&pos, line + len, &values[fields]))
+    {
+        fields++;
+    }
+
+    /* trailing text is ignored as sscanf did, but a number scan_int stopped on overflowed */
+    bool overflow = false;
+    if (fields < 4)
+    {
+        while (pos < line + len && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\v' || *pos == '\f'))
+            pos++;
+        if (pos < line + len && (*pos == '-' || *pos == '+'))
+            pos++;
+        overflow = (pos < line + len && *pos >= '0' && *pos <= '9');
+    }
+
+    if (fields < 2 || overflow)
+    {
+        if (warn)
+            fprintf(stderr, "Warning: Line %d in input file has invalid format, skipping\n", line_num);
+        return false;
+    }
+
+    if (values[1] <= 0)
+    {
+        if (warn)
+            fprintf(stderr, "Warning: Line %d in input file has invalid process size (%d), skipping\n", line_num, values[1]);
+        return false;
+    }
+
+    proc->id = values[0];
+    proc->req_size = values[1];
+    proc->arrival_time = values[2];
+    proc->duration = values[3];
+    proc->status = PROC_NEW;
+    proc->handle = NO_BLOCK;
+    return true;
+}
+
+bool load_procs_from_file(const char *filename, Proc **procs, int *num_procs, int *mem_capacity, long long *bytes_read)
+{
+    LineReader reader;
+    if (!line_reader_open(&reader, filename))
+    {
+        return false;
+    }
+
+    const char *line;
+    size_t len;
+    int line_num = 0;
+
+    if (!line_reader_next(&reader, &line, &len) || !parse_capacity_line(line, len, mem_capacity))
+    {
+        fprintf(stderr, "Error: Line 1 in input file must give the memory size\n");
+        line_reader_close(&reader);
+        return false;
+    }
+    line_num++;
+
+    *num_procs = 0;
+    int proc_cap = 0;
+    *procs = NULL;
+
+    while (line_reader_next(&reader, &line, &len))
+    {
+        line_num++;
+
+        Proc proc;
+        if (!parse_proc_line(line, len, line_num, &proc, true))
+        {
+            continue;
+        }
+
+        if (*num_procs == proc_cap)
+        {
+            int new_cap = (proc_cap > 0) ? proc_cap * 2 : INIT_PROC_CAP;
+            Proc *grown = realloc(*procs, sizeof(Proc) * new_cap);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "Error: Out of memory after %d processes\n", *num_procs);
+                line_reader_close(&reader);
+                return false;
+            }
+            *procs = grown;
+            proc_cap = new_cap;
+        }
+
+        (*procs)[(*num_procs)++] = proc;
+    }
+
+    *bytes_read = reader.bytes;
+    line_reader_close(&reader);
+
+    if (*num_procs == 0)
+    {
+        fprintf(stderr, "Warning: No valid processes found in input file\n");
+        return false;
+    }
+
+    return true;
+}
+
+void print_mem_simple(MemMgr *mgr, Proc procs[], int num_procs)
+{
+    event_log_flush(mgr);
+    fprintf(mgr->out, "\nMemory Summary: Used: %d KB (%.1f%%), Free: %d KB (%.1f%%)\n",
+                      mgr->full_size - mgr->avail_size,
+                      ((double)(mgr->full_size - mgr->avail_size) / mgr->full_size) * 100.0,
+                      mgr->avail_size,
+                      ((double)mgr->avail_size / mgr->full_size) * 100.0);
+
+    fprintf(mgr->out, "Blocks: Total: %d, Free: %d\n", mgr->num_blocks, mgr->free_blocks);
+
+    int running = 0, terminated = 0, new_count = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (procs[i].status == PROC_ACTIVE)
+            running++;
+        else if (procs[i].status == PROC_DONE)
+            terminated++;
+        else if (procs[i].status == PROC_NEW)
+            new_count++;
+    }
+
+    fprintf(mgr->out, "Processes: Running: %d, Terminated: %d, Unallocated: %d\n",
+                      running, terminated, new_count);
+}
+
+void print_mem_detailed(MemMgr *mgr, Proc procs[], int num_procs)
+{
+    event_log_flush(mgr);
+    fprintf(mgr->out, "\nMemory Allocation Table:\n");
+    fprintf(mgr->out, "%-4s %-15s %-12s %-12s\n", "ID", "State", "Size", "Location");
+    fprintf(mgr->out, "------------------------------------------\n");
+
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (procs[i].status != PROC_NEW)
+        {
+            const char *state_str = (procs[i].status == PROC_ACTIVE) ? "Running" : "Terminated";
+
+            fprintf(mgr->out, "%-4d %-15s %-12d ",
+                              procs[i].id,
+                              state_str,
+                              procs[i].req_size);
+
+            int blk = resolve_handle(mgr, procs[i].handle);
+            if (blk != -1)
+            {
+                fprintf(mgr->out, "%-12d\n", block_at(mgr, blk)->begin_addr);
+            }
+            else
+            {
+                fprintf(mgr->out, "N/A\n");
+            }
+        }
+    }
+
+    fprintf(mgr->out, "\nMemory Status:\n");
+    fprintf(mgr->out, "Total Memory: %d KB, Used: %d KB, Free: %d KB\n",
+                      mgr->full_size,
+                      mgr->full_size - mgr->avail_size,
+                      mgr->avail_size);
+
+    fprintf(mgr->out, "\nBlock List Details:\n");
+    fprintf(mgr->out, "%-8s %-8s %-16s %-8s\n", "Start", "Size", "Status", "Process");
+    fprintf(mgr->out, "------------------------------------------\n");
+
+    for (int i = mgr->head; i != -1; i = block_at(mgr, i)->next)
+    {
+        fprintf(mgr->out, "%-8d %-8d %-16s %-8d\n",
+                          block_at(mgr, i)->begin_addr,
+                          block_at(mgr, i)->chunk_size,
+                          block_at(mgr, i)->available ? "Free" : "Allocated",
+                          block_at(mgr, i)->proc_id);
+    }
+
+    fprintf(mgr->out, "\nFree Block Sizes (KB):");
+    for (int b = 0; b < FREE_HIST_BUCKETS; b++)
+    {
+        if (mgr->free_hist[b] > 0)
+            fprintf(mgr->out, " [%lld-%lld]: %d", 1LL << b, (2LL << b) - 1, mgr->free_hist[b]);
+    }
+    fprintf(mgr->out, "\n\n");
+}
+
+void update_frag_metrics(MemMgr *mgr, Stats *stats)
+{
+    long long total_alloc_size = mgr->full_size - mgr->avail_size;
+
+    stats->ext_frag = mgr->free_blocks;
+    stats->int_frag = (int)mgr->int_frag;
+    stats->int_frag_percent = (total_alloc_size > 0) ? ((double)mgr->int_frag / total_alloc_size) * 100.0 : 0.0;
+    stats->avg_frag_size = (mgr->free_blocks > 0) ? (double)mgr->avail_size / mgr->free_blocks : 0.0;
+    stats->frag_percent = (mgr->avail_size > 0 && mgr->free_blocks > 1)
+                              ? ((double)(mgr->avail_size - largest_free_block(mgr)) / mgr->avail_size) * 100.0
+                              : 0.0;
+}
+
+const char *method_title(AllocMethod method)
+{
+    switch (method)
+    {
+    case FIRST_APPROACH:
+        return "First-Fit";
+    case BEST_APPROACH:
+        return "Best-Fit";
+    case WORST_APPROACH:
+        return "Worst-Fit";
+    case NEXT_APPROACH:
+        return "Next-Fit";
+    case BUDDY_APPROACH:
+        return "Buddy";
+    case TLSF_APPROACH:
+        return "TLSF";
+    }
+    return "Unknown";
+}
+
+void run_sim(MemMgr *mgr, AllocMethod method,
+                     Proc procs[], int num_procs, Stats *stats)
+{
+    memset(stats, 0, sizeof(Stats));
+
+    fprintf(mgr->out, "\n=== %s Strategy Simulation ===\n",
+                      method_title(method));
+
+    fprintf(mgr->out, "\n--- Phase 1: Initial Process Allocation ---\n");
+    int num_to_allocate;
+    fprintf(mgr->out, "How many processes do you want to allocate initially? (max %d): ", num_procs);
+    scanf("%d", &num_to_allocate);
+
+    if (num_to_allocate <= 0)
+        num_to_allocate = 1;
+    else if (num_to_allocate > num_procs)
+        num_to_allocate = num_procs;
+
+    for (int i = 0; i < num_to_allocate; i++)
+    {
+        stats->alloc_tries++;
+
+        bool placed = allocate_mem(mgr, &procs[i]);
+        if (placed)
+            stats->alloc_success++;
+        else
+            stats->alloc_fails++;
+        if (mgr->verbosity != VERBOSITY_OFF)
+            log_event(mgr, LOG_PLACED, procs[i].id, placed, 0, 0);
+    }
+    event_log_flush(mgr);
+    fprintf(mgr->out, "\n");
+
+    double current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+    stats->max_usage = current_util;
+
+    print_mem_simple(mgr, procs, num_procs);
+
+    fprintf(mgr->out, "\n--- Phase 2: Process Termination ---\n");
+    fprintf(mgr->out, "Running processes: ");
+    int running_count = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (procs[i].status == PROC_ACTIVE)
+        {
+            fprintf(mgr->out, "P%d ", procs[i].id);
+            running_count++;
+        }
+    }
+    fprintf(mgr->out, "\n");
+
+    if (running_count > 0)
+    {
+        fprintf(mgr->out, "Enter number of processes to terminate ([0] for none, [-1] for all, [1-%d] for specific processes): ", running_count);
+        int num_to_terminate;
+        scanf("%d", &num_to_terminate);
+
+        if (num_to_terminate == -1)
+        {
+            fprintf(mgr->out, "Terminating all running processes\n");
+            for (int i = 0; i < num_procs; i++)
+            {
+                if (procs[i].status == PROC_ACTIVE)
+                {
+                    free_mem(mgr, &procs[i]);
+                }
+            }
+        }
+        else
+        {
+            if (num_to_terminate < 0)
+                num_to_terminate = 0;
+            if (num_to_terminate > running_count)
+                num_to_terminate = running_count;
+
+            for (int i = 0; i < num_to_terminate; i++)
+            {
+                int process_id;
+                fprintf(mgr->out, "Enter process ID to terminate: ");
+                scanf("%d", &process_id);
+
+                bool found = false;
+                for (int j = 0; j < num_procs; j++)
+                {
+                    if (procs[j].id == process_id && procs[j].status == PROC_ACTIVE)
+                    {
+                        found = true;
+                        free_mem(mgr, &procs[j]);
+                        fprintf(mgr->out, "Terminated P%d\n", process_id);
+                        break;
+                    }
+                }
+
+                if (!found)
+                {
+                    fprintf(mgr->out, "P%d not found or not running\n", process_id);
+                }
+            }
+        }
+    }
+    else
+    {
+        fprintf(mgr->out, "No running processes to terminate.\n");
+    }
+
+    print_mem_simple(mgr, procs, num_procs);
+
+    fprintf(mgr->out, "\n--- Phase 3: Additional Process Allocation ---\n");
+    fprintf(mgr->out, "Remaining unallocated processes: ");
+    int unalloc_count = 0;
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (procs[i].status == PROC_NEW)
+        {
+            fprintf(mgr->out, "P%d ", procs[i].id);
+            unalloc_count++;
+        }
+    }
+    fprintf(mgr->out, "\n");
+
+    if (unalloc_count > 0)
+    {
+        fprintf(mgr->out, "How many more processes do you want to allocate ([0] for none, [1-%d] for specific processes): ", unalloc_count);
+        int more_to_allocate;
+        scanf("%d", &more_to_allocate);
+
+        if (more_to_allocate < 0)
+            more_to_allocate = 0;
+        if (more_to_allocate > unalloc_count)
+            more_to_allocate = unalloc_count;
+
+        int alloc_count = 0;
+
+        for (int i = 0; i < num_procs && alloc_count < more_to_allocate; i++)
+        {
+            if (procs[i].status == PROC_NEW)
+            {
+                stats->alloc_tries++;
+
+                bool placed = allocate_mem(mgr, &procs[i]);
+                if (placed)
+                    stats->alloc_success++;
+                else
+                    stats->alloc_fails++;
+                if (mgr->verbosity != VERBOSITY_OFF)
+                    log_event(mgr, LOG_PLACED, procs[i].id, placed, 0, 0);
+
+                alloc_count++;
+            }
+        }
+        event_log_flush(mgr);
+        fprintf(mgr->out, "\n");
+    }
+    else
+    {
+        fprintf(mgr->out, "No more processes to allocate.\n");
+    }
+
+    current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+    if (current_util > stats->max_usage)
+    {
+        stats->max_usage = current_util;
+    }
+
+    print_mem_simple(mgr, procs, num_procs);
+
+    fprintf(mgr->out, "\n--- Phase 4: Large Process Allocation ---\n");
+    float pct_input = 0.0f;
+    do
+    {
+        fprintf(mgr->out, "Enter size for a large process (P9999) allocation (as %% of available free memory, 1–100): ");
+        if (scanf("%f", &pct_input) != 1)
+        {
+            fprintf(mgr->out, "Invalid input. Please enter a number.\n");
+            while (getchar() != '\n')
+                ;
+            pct_input = 0.0f;
+        }
+        else if (pct_input < 1.0f || pct_input > 100.0f)
+        {
+            fprintf(mgr->out, "Please enter a valid percentage between 1 and 100.\n");
+            pct_input = 0.0f;
+        }
+    } while (pct_input == 0.0f);
+
+    int large_size = (int)((mgr->avail_size * pct_input) / 100.0f);
+
+    Proc large_proc;
+    large_proc.id = 9999;
+    large_proc.req_size = large_size;
+    large_proc.arrival_time = 0;
+    large_proc.duration = 0;
+    large_proc.status = PROC_NEW;
+    large_proc.handle = NO_BLOCK;
+
+    stats->alloc_tries++;
+    fprintf(mgr->out, "Attempting large allocation (P9999, %dKB - %.2f%% of available free memory): ", large_proc.req_size, pct_input);
+
+    /* timed like allocate_or_compact, leaving out the progress messages */
+    unsigned long long start = read_ticks();
+    bool placed = place_proc(mgr, &large_proc);
+    unsigned long long ticks = read_ticks() - start;
+    if (!placed && can_compact(mgr, &large_proc))
+    {
+        fprintf(mgr->out, "FAILED (not enough contiguous space)\n");
+        start = read_ticks();
+        compact_mem(mgr);
+        ticks += read_ticks() - start;
+        event_log_flush(mgr);
+        fprintf(mgr->out, "Retrying P9999 after compaction: ");
+        start = read_ticks();
+        placed = place_after_compact(mgr, &large_proc);
+        ticks += read_ticks() - start;
+    }
+    latency_record(&mgr->alloc_lat, ticks);
+    record_usage(mgr);
+
+    if (placed)
+    {
+        stats->alloc_success++;
+        fprintf(mgr->out, "SUCCESS\n");
+        procs[num_procs] = large_proc;
+        num_procs++;
+    }
+    else
+    {
+        stats->alloc_fails++;
+        fprintf(mgr->out, "FAILED (not enough contiguous space)\n");
+    }
+
+    current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+    if (current_util > stats->max_usage)
+    {
+        stats->max_usage = current_util;
+    }
+
+    stats->avg_usage = usage_time_average(mgr);
+
+    update_frag_metrics(mgr, stats);
+    print_mem_simple(mgr, procs, num_procs);
+
+    fprintf(mgr->out, "\n--- Final Memory State (Detailed) ---\n");
+    print_mem_detailed(mgr, procs, num_procs);
+
+    fprintf(mgr->out, "\n--- Final Results (%s) ---\n",
+                      method_title(method));
+
+    fprintf(mgr->out, "Success Rate: %.1f%% (%d/%d)\n",
+                      ((double)stats->alloc_success / stats->alloc_tries) * 100.0,
+                      stats->alloc_success, stats->alloc_tries);
+    fprintf(mgr->out, "Peak Memory Usage: %.1f%%\n", stats->max_usage * 100.0);
+    fprintf(mgr->out, "Fragmentation: %.1f%%\n", stats->frag_percent);
+    fprintf(mgr->out, "Internal Fragmentation: %d KB (%.1f%% of allocated)\n", stats->int_frag, stats->int_frag_percent);
+    fprintf(mgr->out, "Final Block Count: %d\n", mgr->num_blocks);
+    if (mgr->compactions > 0)
+        fprintf(mgr->out, "Compaction: %d passes, %lld KB moved in %.3f ms\n", mgr->compactions, mgr->compact_moved,
+                          mgr->compact_ticks / ticks_per_ns() / 1e6);
+
+    fprintf(mgr->out, "\n--- %s Simulation Completed ---\n",
+                      method_title(method));
+    fprintf(mgr->out, "\n\n****************************************************************************************************************************\n\n");
+}
+
+static bool event_before(const SimEvent *a, const SimEvent *b)
+{
+    if (a->time != b->time)
+        return a->time < b->time;
+    if (a->kind != b->kind)
+        return a->kind < b->kind;
+    return a->seq < b->seq;
+}
+
+bool event_queue_push(EventQueue *queue, SimEvent event)
+{
+    if (queue->len == queue->cap)
+    {
+        int new_cap = (queue->cap > 0) ? queue->cap * 2 : 64;
+        SimEvent *grown = realloc(queue->events, sizeof(SimEvent) * new_cap);
+        if (grown == NULL)
+            return false;
+        queue->events = grown;
+        queue->cap = new_cap;
+    }
+
+    int pos = queue->len++;
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (!event_before(&event, &queue->events[parent]))
+            break;
+        queue->events[pos] = queue->events[parent];
+        pos = parent;
+    }
+    queue->events[pos] = event;
+    return true;
+}
+
+bool event_queue_pop(EventQueue *queue, SimEvent *out)
+{
+    if (queue->len == 0)
+        return false;
+
+    *out = queue->events[0];
+    SimEvent last = queue->events[--queue->len];
+
+    int pos = 0;
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= queue->len)
+            break;
+        if (child + 1 < queue->len && event_before(&queue->events[child + 1], &queue->events[child]))
+            child++;
+        if (!event_before(&queue->events[child], &last))
+            break;
+        queue->events[pos] = queue->events[child];
+        pos = child;
+    }
+    if (queue->len > 0)
+        queue->events[pos] = last;
+    return true;
+}
+
+static int live_take(LiveTable *table)
+{
+    if (table->num_spare == 0)
+    {
+        int new_cap = (table->cap > 0) ? table->cap * 2 : 64;
+        Proc *procs = realloc(table->procs, sizeof(Proc) * new_cap);
+        if (procs == NULL)
+            return -1;
+        table->procs = procs;
+
+        int *spare = realloc(table->spare, sizeof(int) * new_cap);
+        if (spare == NULL)
+            return -1;
+        table->spare = spare;
+
+        for (int i = new_cap - 1; i >= table->cap; i--)
+        {
+            table->spare[table->num_spare++] = i;
+        }
+        table->cap = new_cap;
+    }
+    return table->spare[--table->num_spare];
+}
+
+static void live_put(LiveTable *table, int slot)
+{
+    table->spare[table->num_spare++] = slot;
+}
+
+static FeedStatus schedule_arrival(ProcFeed feed, void *feed_ctx, LiveTable *live,
+                                   EventQueue *queue, long long *seq, long long clock)
+{
+    int slot = live_take(live);
+    if (slot == -1)
+        return FEED_NO_MEMORY;
+
+    if (!feed(feed_ctx, &live->procs[slot]))
+    {
+        live_put(live, slot);
+        return FEED_DONE;
+    }
+
+    SimEvent event;
+    event.time = live->procs[slot].arrival_time;
+    if (event.time < clock)
+    {
+        fprintf(stderr, "Warning: P%d arrives at %lld, before the clock (%lld); admitting it now\n",
+                live->procs[slot].id, event.time, clock);
+        event.time = clock;
+    }
+    event.seq = (*seq)++;
+    event.kind = EVENT_ARRIVE;
+    event.slot = slot;
+    if (!event_queue_push(queue, event))
+    {
+        live_put(live, slot);
+        return FEED_NO_MEMORY;
+    }
+    return FEED_SCHEDULED;
+}
+
+static double current_frag_percent(MemMgr *mgr)
+{
+    if (mgr->avail_size <= 0)
+        return 0.0;
+    return ((double)(mgr->avail_size - largest_free_block(mgr)) / mgr->avail_size) * 100.0;
+}
+
+bool run_event_sim(MemMgr *mgr, ProcFeed feed, void *feed_ctx, Stats *stats)
+{
+    memset(stats, 0, sizeof(Stats));
+
+    if (mgr->out != NULL)
+        fprintf(mgr->out, "\n=== %s Event Simulation ===\n", method_title(mgr->method));
+
+    EventQueue queue = {0};
+    LiveTable live = {0};
+    long long seq = 0;
+    long long clock = 0;
+    long long start_time = 0;
+    long long num_events = 0;
+    bool started = false;
+    FeedStatus feeding = schedule_arrival(feed, feed_ctx, &live, &queue, &seq, LLONG_MIN);
+    bool ok = (feeding != FEED_NO_MEMORY);
+
+    double cur_util = 0.0;
+    double cur_frag = 0.0;
+    double frag_area = 0.0;
+
+    mgr->clocked = true;
+
+    SimEvent event;
+    while (ok && event_queue_pop(&queue, &event))
+    {
+        if (!started)
+        {
+            start_time = clock = event.time;
+            started = true;
+        }
+
+        frag_area += cur_frag * (double)(event.time - clock);
+        clock = event.time;
+        mgr->now = clock;
+        num_events++;
+
+        Proc *proc = &live.procs[event.slot];
+
+        if (event.kind == EVENT_ARRIVE)
+        {
+            stats->alloc_tries++;
+
+            if (allocate_or_compact(mgr, proc))
+            {
+                stats->alloc_success++;
+                if (mgr->verbosity != VERBOSITY_OFF)
+                    log_event(mgr, LOG_ARRIVE, proc->id, proc->req_size,
+                              block_at(mgr, proc->handle.slot)->begin_addr, 0);
+
+                SimEvent depart;
+                depart.time = clock + (proc->duration > 0 ? proc->duration : 0);
+                depart.seq = seq++;
+                depart.kind = EVENT_DEPART;
+                depart.slot = event.slot;
+                if (!event_queue_push(&queue, depart))
+                {
+                    ok = false;
+                    break;
+                }
+            }
+            else
+            {
+                stats->alloc_fails++;
+                if (mgr->verbosity != VERBOSITY_OFF)
+                    log_event(mgr, LOG_ARRIVE_FAILED, proc->id, proc->req_size, 0, 0);
+                live_put(&live, event.slot);
+            }
+
+            if (feeding == FEED_SCHEDULED)
+            {
+                feeding = schedule_arrival(feed, feed_ctx, &live, &queue, &seq, clock);
+                if (feeding == FEED_NO_MEMORY)
+                {
+                    ok = false;
+                    break;
+                }
+                if (feeding == FEED_DONE)
+                {
+                    update_frag_metrics(mgr, stats);
+                }
+            }
+        }
+        else
+        {
+            if (mgr->verbosity != VERBOSITY_OFF)
+                log_event(mgr, LOG_DEPART, proc->id, 0, 0, 0);
+            free_mem(mgr, proc);
+            live_put(&live, event.slot);
+        }
+
+        cur_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+        cur_frag = current_frag_percent(mgr);
+        if (cur_util > stats->max_usage)
+        {
+            stats->max_usage = cur_util;
+        }
+    }
+
+    if (!ok)
+    {
+        /* stopping early would report a truncated workload as a finished run */
+        fprintf(stderr, "Error: Out of memory growing the event calendar\n");
+        free(queue.events);
+        free(live.procs);
+        free(live.spare);
+        return false;
+    }
+
+    long long span = clock - start_time;
+    stats->avg_usage = usage_time_average(mgr);
+    if (span > 0)
+    {
+        stats->frag_percent = frag_area / span;
+    }
+
+    /* a NULL out collects Stats only, as the sweep workers do */
+    if (mgr->out != NULL)
+    {
+        event_log_flush(mgr);
+        fprintf(mgr->out, "\n--- Final Results (%s, event-driven) ---\n", method_title(mgr->method));
+        fprintf(mgr->out, "Events Processed: %lld over %lld time units\n", num_events, span);
+        fprintf(mgr->out, "Success Rate: %.1f%% (%d/%d)\n",
+                          (stats->alloc_tries > 0) ? ((double)stats->alloc_success / stats->alloc_tries) * 100.0 : 0.0,
+                          stats->alloc_success, stats->alloc_tries);
+        fprintf(mgr->out, "Peak Memory Usage: %.1f%%\n", stats->max_usage * 100.0);
+        fprintf(mgr->out, "Time-Weighted Memory Usage: %.1f%%\n", stats->avg_usage * 100.0);
+        fprintf(mgr->out, "Time-Weighted Fragmentation: %.1f%%\n", stats->frag_percent);
+        fprintf(mgr->out, "Free Blocks at Last Arrival: %d (avg %.1f KB)\n", stats->ext_frag, stats->avg_frag_size);
+        fprintf(mgr->out, "Internal Fragmentation at Last Arrival: %d KB (%.1f%% of allocated)\n",
+                          stats->int_frag, stats->int_frag_percent);
+        if (mgr->compactions > 0)
+            fprintf(mgr->out, "Compaction: %d passes, %lld KB moved in %.3f ms\n", mgr->compactions, mgr->compact_moved,
+                              mgr->compact_ticks / ticks_per_ns() / 1e6);
+    }
+
+    free(queue.events);
+    free(live.procs);
+    free(live.spare);
+    return true;
+}
+
+static int arrival_key_cmp(const void *a, const void *b)
+{
+    const long long *x = a;
+    const long long *y = b;
+    return (*x > *y) - (*x < *y);
+}
+
+int *sort_by_arrival(Proc procs[], int num_procs)
+{
+    long long *keys = malloc(sizeof(long long) * num_procs);
+    int *order = malloc(sizeof(int) * num_procs);
+    if (keys == NULL || order == NULL)
+    {
+        free(keys);
+        free(order);
+        return NULL;
+    }
+
+    for (int i = 0; i < num_procs; i++)
+    {
+        keys[i] = (long long)procs[i].arrival_time * 4294967296LL + i;
+    }
+    qsort(keys, num_procs, sizeof(long long), arrival_key_cmp);
+    for (int i = 0; i < num_procs; i++)
+    {
+        order[i] = (int)(keys[i] - (keys[i] >> 32) * 4294967296LL);
+    }
+
+    free(keys);
+    return order;
+}
+
+static unsigned int proc_map_hash(int id)
+{
+    unsigned int h = (unsigned int)id * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+static bool proc_map_grow(ProcMap *map)
+{
+    int new_cap = (map->cap > 0) ? map->cap * 2 : 1024;
+    int *keys = malloc(sizeof(int) * new_cap);
+    int *slots = malloc(sizeof(int) * new_cap);
+    if (keys == NULL || slots == NULL)
+    {
+        free(keys);
+        free(slots);
+        return false;
+    }
+
+    for (int i = 0; i < new_cap; i++)
+    {
+        slots[i] = -1;
+    }
+    for (int i = 0; i < map->cap; i++)
+    {
+        if (map->slots[i] == -1)
+            continue;
+        unsigned int pos = proc_map_hash(map->keys[i]) & (new_cap - 1);
+        while (slots[pos] != -1)
+            pos = (pos + 1) & (new_cap - 1);
+        keys[pos] = map->keys[i];
+        slots[pos] = map->slots[i];
+    }
+
+    free(map->keys);
+    free(map->slots);
+    map->keys = keys;
+    map->slots = slots;
+    map->cap = new_cap;
+    return true;
+}
+
+int proc_map_find(ProcMap *map, int id)
+{
+    if (map->cap == 0)
+        return -1;
+
+    unsigned int pos = proc_map_hash(id) & (map->cap - 1);
+    while (map->slots[pos] != -1)
+    {
+        if (map->keys[pos] == id)
+            return map->slots[pos];
+        pos = (pos + 1) & (map->cap - 1);
+    }
+    return -1;
+}
+
+bool proc_map_put(ProcMap *map, int id, int slot)
+{
+    if ((map->len + 1) * 2 > map->cap && !proc_map_grow(map))
+        return false;
+
+    unsigned int pos = proc_map_hash(id) & (map->cap - 1);
+    while (map->slots[pos] != -1 && map->keys[pos] != id)
+        pos = (pos + 1) & (map->cap - 1);
+    if (map->slots[pos] == -1)
+        map->len++;
+    map->keys[pos] = id;
+    map->slots[pos] = slot;
+    return true;
+}
 
-        int id, size, arrival_time = 0, duration = 10;
-        int fields = sscanf(line, "%d %d %d %d", &id, &size, &arrival_time, &duration);
+void proc_map_remove(ProcMap *map, int id)
+{
+    if (map->cap == 0)
+        return;
+
+    unsigned int mask = map->cap - 1;
+    unsigned int pos = proc_map_hash(id) & mask;
+    while (map->slots[pos] != -1 && map->keys[pos] != id)
+        pos = (pos + 1) & mask;
+    if (map->slots[pos] == -1)
+        return;
 
-        if (fields < 2)
+    /* backward-shift deletion keeps probe chains intact without tombstones */
+    unsigned int hole = pos;
+    for (unsigned int next = (hole + 1) & mask; map->slots[next] != -1; next = (next + 1) & mask)
+    {
+        unsigned int home = proc_map_hash(map->keys[next]) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            map->keys[hole] = map->keys[next];
+            map->slots[hole] = map->slots[next];
+            hole = next;
+        }
+    }
+    map->slots[hole] = -1;
+    map->len--;
+}
+
+bool load_script(const char *filename, Script *script)
+{
+    FILE *in_file = fopen(filename, "r");
+    if (in_file == NULL)
+    {
+        fprintf(stderr, "Error: Could not open script file '%s'\n", filename);
+        return false;
+    }
+
+    char line[MAX_LINE_LEN];
+    int line_num = 0;
+    bool have_capacity = false;
+
+    script->capacity = 0;
+    script->ops = NULL;
+    script->num_ops = 0;
+    script->cap = 0;
+
+    while (fgets(line, MAX_LINE_LEN, in_file) != NULL)
+    {
+        line_num++;
+
+        if (line[0] == '\n' || line[0] == '#')
         {
-            fprintf(stderr, "Warning: Line %d in input file has invalid format, skipping\n", line_num);
             continue;
         }
 
-        if (size <= 0)
+        if (!have_capacity)
         {
-            fprintf(stderr, "Warning: Line %d in input file has invalid process size (%d), skipping\n", line_num, size);
+            if (sscanf(line, "%d", &script->capacity) != 1 || script->capacity <= 0)
+            {
+                fprintf(stderr, "Error: Line %d in script must give the memory size\n", line_num);
+                fclose(in_file);
+                return false;
+            }
+            have_capacity = true;
             continue;
         }
 
-        procs[*num_procs].id = id;
-        procs[*num_procs].req_size = size;
-        procs[*num_procs].status = PROC_NEW;
-        procs[*num_procs].block_idx = -1;
+        ScriptOp op = {OP_ALLOC, 9999, 0, 0.0f};
+        char kind = '\0';
+        int fields = 0;
 
-        (*num_procs)++;
+        if (sscanf(line, " %c", &kind) != 1)
+        {
+            continue;
+        }
+
+        switch (kind)
+        {
+        case 'a':
+            op.kind = OP_ALLOC;
+            fields = sscanf(line, " %*c %d %d", &op.id, &op.size);
+            fields = (fields == 2 && op.size > 0);
+            break;
+        case 'f':
+            op.kind = OP_FREE;
+            fields = (sscanf(line, " %*c %d", &op.id) == 1);
+            break;
+        case 'F':
+            op.kind = OP_FREE_ALL;
+            fields = 1;
+            break;
+        case 'L':
+            op.kind = OP_LARGE;
+            fields = sscanf(line, " %*c %f %d", &op.pct, &op.id);
+            fields = (fields >= 1 && op.pct >= 1.0f && op.pct <= 100.0f);
+            break;
+        default:
+            fields = 0;
+            break;
+        }
+
+        if (!fields)
+        {
+            fprintf(stderr, "Warning: Line %d in script has invalid format, skipping\n", line_num);
+            continue;
+        }
+
+        if (script->num_ops == script->cap)
+        {
+            long long new_cap = (script->cap > 0) ? script->cap * 2 : 1024;
+            ScriptOp *grown = realloc(script->ops, sizeof(ScriptOp) * new_cap);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "Error: Out of memory after %lld script operations\n", script->num_ops);
+                fclose(in_file);
+                return false;
+            }
+            script->ops = grown;
+            script->cap = new_cap;
+        }
+        script->ops[script->num_ops++] = op;
     }
 
     fclose(in_file);
 
-    if (*num_procs == 0)
+    if (!have_capacity)
     {
-        fprintf(stderr, "Warning: No valid processes found in input file\n");
+        fprintf(stderr, "Error: Script file '%s' is empty\n", filename);
+        return false;
+    }
+    return true;
+}
+
+static void script_alloc(MemMgr *mgr, LiveTable *live, ProcMap *map, int id, int size, Stats *stats)
+{
+    stats->alloc_tries++;
+
+    int slot = (proc_map_find(map, id) == -1) ? live_take(live) : -1;
+    if (slot == -1)
+    {
+        stats->alloc_fails++;
+        return;
+    }
+
+    Proc *proc = &live->procs[slot];
+    proc->id = id;
+    proc->req_size = size;
+    proc->arrival_time = 0;
+    proc->duration = 0;
+    proc->status = PROC_NEW;
+    proc->handle = NO_BLOCK;
+
+    if (size > 0 && allocate_or_compact(mgr, proc) && proc_map_put(map, id, slot))
+    {
+        stats->alloc_success++;
+    }
+    else
+    {
+        free_mem(mgr, proc);
+        stats->alloc_fails++;
+        live_put(live, slot);
+    }
+}
+
+static void script_free(MemMgr *mgr, LiveTable *live, ProcMap *map, int id)
+{
+    int slot = proc_map_find(map, id);
+    if (slot == -1)
+        return;
+
+    free_mem(mgr, &live->procs[slot]);
+    proc_map_remove(map, id);
+    live_put(live, slot);
+}
+
+void run_script(MemMgr *mgr, const Script *script, Stats *stats)
+{
+    memset(stats, 0, sizeof(Stats));
+
+    fprintf(mgr->out, "\n=== %s Scripted Run ===\n", method_title(mgr->method));
+
+    LiveTable live = {0};
+    ProcMap map = {0};
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (long long i = 0; i < script->num_ops; i++)
+    {
+        const ScriptOp *op = &script->ops[i];
+
+        switch (op->kind)
+        {
+        case OP_ALLOC:
+            script_alloc(mgr, &live, &map, op->id, op->size, stats);
+            break;
+        case OP_FREE:
+            script_free(mgr, &live, &map, op->id);
+            break;
+        case OP_FREE_ALL:
+            for (int pos = 0; pos < map.cap; pos++)
+            {
+                if (map.slots[pos] == -1)
+                    continue;
+                free_mem(mgr, &live.procs[map.slots[pos]]);
+                live_put(&live, map.slots[pos]);
+                map.slots[pos] = -1;
+            }
+            map.len = 0;
+            break;
+        case OP_LARGE:
+            script_alloc(mgr, &live, &map, op->id,
+                         (int)((mgr->avail_size * op->pct) / 100.0f), stats);
+            break;
+        }
+
+        double current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
+        if (current_util > stats->max_usage)
+        {
+            stats->max_usage = current_util;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    stats->avg_usage = usage_time_average(mgr);
+    update_frag_metrics(mgr, stats);
+
+    fprintf(mgr->out, "Operations: %lld in %.3f s (%.0f ops/sec)\n", script->num_ops, elapsed,
+                      (elapsed > 0.0) ? script->num_ops / elapsed : 0.0);
+    fprintf(mgr->out, "Success Rate: %.1f%% (%d/%d)\n",
+                      (stats->alloc_tries > 0) ? ((double)stats->alloc_success / stats->alloc_tries) * 100.0 : 0.0,
+                      stats->alloc_success, stats->alloc_tries);
+    fprintf(mgr->out, "Peak Memory Usage: %.1f%%\n", stats->max_usage * 100.0);
+    fprintf(mgr->out, "Average Memory Usage: %.1f%%\n", stats->avg_usage * 100.0);
+    fprintf(mgr->out, "Fragmentation: %.1f%%\n", stats->frag_percent);
+    fprintf(mgr->out, "Final Block Count: %d\n", mgr->num_blocks);
+    if (mgr->compactions > 0)
+        fprintf(mgr->out, "Compaction: %d passes, %lld KB moved in %.3f ms\n", mgr->compactions, mgr->compact_moved,
+                          mgr->compact_ticks / ticks_per_ns() / 1e6);
+
+    free(live.procs);
+    free(live.spare);
+    free(map.keys);
+    free(map.slots);
+}
+
+static unsigned long long rng_next(Rng *rng)
+{
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* uniform on (0, 1]: never zero, so it is safe to take log() of */
+static double rng_unit(Rng *rng)
+{
+    return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_exponential(Rng *rng, double mean)
+{
+    return -mean * log(rng_unit(rng));
+}
+
+static int gen_size(GenFeed *feed)
+{
+    const GenConfig *cfg = feed->cfg;
+    double size;
+
+    switch (cfg->dist)
+    {
+    case SIZE_EXPONENTIAL:
+        size = rng_exponential(&feed->rng, cfg->mean_size);
+        break;
+    case SIZE_PARETO:
+        size = cfg->min_size / pow(rng_unit(&feed->rng), 1.0 / cfg->alpha);
+        break;
+    case SIZE_BIMODAL:
+        if (rng_unit(&feed->rng) <= cfg->big_frac)
+            size = cfg->max_size / 2 + rng_unit(&feed->rng) * (cfg->max_size - cfg->max_size / 2);
+        else
+            size = rng_exponential(&feed->rng, cfg->mean_size);
+        break;
+    case SIZE_UNIFORM:
+    default:
+        size = cfg->min_size + (1.0 - rng_unit(&feed->rng)) * (cfg->max_size - cfg->min_size + 1);
+        break;
+    }
+
+    if (size < cfg->min_size)
+        return cfg->min_size;
+    if (size > cfg->max_size)
+        return cfg->max_size;
+    return (int)size;
+}
+
+static int clamp_time(double t)
+{
+    return (t < (double)INT_MAX) ? (int)t : INT_MAX;
+}
+
+void gen_feed_init(GenFeed *feed, const GenConfig *cfg)
+{
+    feed->cfg = cfg;
+    feed->rng.state = cfg->seed;
+    feed->clock = 0.0;
+    feed->made = 0;
+}
+
+bool gen_feed_next(void *ctx, Proc *out)
+{
+    GenFeed *feed = ctx;
+    if (feed->made >= feed->cfg->count)
+        return false;
+
+    feed->clock += rng_exponential(&feed->rng, 1.0 / feed->cfg->arrival_rate);
+
+    out->id = ++feed->made;
+    out->req_size = gen_size(feed);
+    out->arrival_time = clamp_time(feed->clock);
+    out->duration = clamp_time(1.0 + rng_exponential(&feed->rng, feed->cfg->mean_life));
+    out->status = PROC_NEW;
+    out->handle = NO_BLOCK;
+    return true;
+}
+
+const char *size_dist_name(SizeDist dist)
+{
+    switch (dist)
+    {
+    case SIZE_UNIFORM:
+        return "uniform";
+    case SIZE_EXPONENTIAL:
+        return "exponential";
+    case SIZE_PARETO:
+        return "pareto";
+    case SIZE_BIMODAL:
+        return "bimodal";
+    }
+    return "unknown";
+}
+
+bool parse_gen_spec(const char *spec, GenConfig *cfg)
+{
+    cfg->seed = 1;
+    cfg->count = 100000;
+    cfg->capacity = 65536;
+    cfg->dist = SIZE_UNIFORM;
+    cfg->min_size = 1;
+    cfg->max_size = 1024;
+    cfg->mean_size = 64.0;
+    cfg->alpha = 1.5;
+    cfg->big_frac = 0.1;
+    cfg->arrival_rate = 1.0;
+    cfg->mean_life = 100.0;
+
+    char buf[MAX_LINE_LEN];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    for (char *item = strtok(buf, ","); item != NULL; item = strtok(NULL, ","))
+    {
+        char *value = strchr(item, '=');
+        if (value == NULL)
+        {
+            fprintf(stderr, "Error: Generator option '%s' is not key=value\n", item);
+            return false;
+        }
+        *value++ = '\0';
+
+        if (strcmp(item, "dist") == 0)
+        {
+            SizeDist dists[] = {SIZE_UNIFORM, SIZE_EXPONENTIAL, SIZE_PARETO, SIZE_BIMODAL};
+            int found = -1;
+            for (int i = 0; i < (int)(sizeof(dists) / sizeof(dists[0])); i++)
+            {
+                if (strcmp(value, size_dist_name(dists[i])) == 0)
+                    found = i;
+            }
+            if (found == -1)
+            {
+                fprintf(stderr, "Error: Unknown size distribution '%s'\n", value);
+                return false;
+            }
+            cfg->dist = dists[found];
+        }
+        else if (strcmp(item, "seed") == 0)
+            cfg->seed = strtoull(value, NULL, 10);
+        else if (strcmp(item, "n") == 0)
+            cfg->count = atoi(value);
+        else if (strcmp(item, "mem") == 0)
+            cfg->capacity = atoi(value);
+        else if (strcmp(item, "min") == 0)
+            cfg->min_size = atoi(value);
+        else if (strcmp(item, "max") == 0)
+            cfg->max_size = atoi(value);
+        else if (strcmp(item, "mean") == 0)
+            cfg->mean_size = atof(value);
+        else if (strcmp(item, "alpha") == 0)
+            cfg->alpha = atof(value);
+        else if (strcmp(item, "big") == 0)
+            cfg->big_frac = atof(value);
+        else if (strcmp(item, "rate") == 0)
+            cfg->arrival_rate = atof(value);
+        else if (strcmp(item, "life") == 0)
+            cfg->mean_life = atof(value);
+        else
+        {
+            fprintf(stderr, "Error: Unknown generator option '%s'\n", item);
+            return false;
+        }
+    }
+
+    if (cfg->count <= 0 || cfg->capacity <= 0 || cfg->min_size <= 0 || cfg->max_size < cfg->min_size ||
+        cfg->mean_size <= 0.0 || cfg->alpha <= 0.0 || cfg->big_frac < 0.0 || cfg->big_frac > 1.0 ||
+        cfg->arrival_rate <= 0.0 || cfg->mean_life <= 0.0)
+    {
+        fprintf(stderr, "Error: Generator options out of range\n");
+        return false;
+    }
+    return true;
+}
+
+bool write_workload(const char *filename, const GenConfig *cfg)
+{
+    FILE *out_file = fopen(filename, "w");
+    if (out_file == NULL)
+    {
+        fprintf(stderr, "Error: Could not open output file '%s'\n", filename);
+        return false;
+    }
+
+    fprintf(out_file, "%d\n", cfg->capacity);
+    fprintf(out_file, "# generated: n=%d dist=%s seed=%llu min=%d max=%d mean=%g alpha=%g big=%g rate=%g life=%g\n",
+            cfg->count, size_dist_name(cfg->dist), cfg->seed, cfg->min_size, cfg->max_size,
+            cfg->mean_size, cfg->alpha, cfg->big_frac, cfg->arrival_rate, cfg->mean_life);
+
+    GenFeed feed;
+    Proc proc;
+    gen_feed_init(&feed, cfg);
+    while (gen_feed_next(&feed, &proc))
+    {
+        fprintf(out_file, "%d %d %d %d\n", proc.id, proc.req_size, proc.arrival_time, proc.duration);
+    }
+
+    bool ok = !ferror(out_file);
+    if (fclose(out_file) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "Error: Failed writing workload to '%s'\n", filename);
+    return ok;
+}
+
+static double student_t95(int df)
+{
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df <= 0)
+        return 0.0;
+    if (df <= (int)(sizeof(table) / sizeof(table[0])))
+        return table[df - 1];
+    return 1.960;
+}
+
+static void sample_interval(const double samples[], int count, double *mean, double *half_width)
+{
+    double sum = 0.0, sq = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += samples[i];
+    }
+    *mean = sum / count;
+
+    for (int i = 0; i < count; i++)
+    {
+        sq += (samples[i] - *mean) * (samples[i] - *mean);
+    }
+    *half_width = (count > 1) ? student_t95(count - 1) * sqrt(sq / (count - 1)) / sqrt(count) : 0.0;
+}
+
+void *sweep_worker(void *arg)
+{
+    SweepPool *pool = arg;
+    int total = pool->trials * pool->num_methods;
+
+
+    while (true)
+    {
+        pthread_mutex_lock(&pool->lock);
+        int job = pool->failed ? total : pool->next_job++;
+        pthread_mutex_unlock(&pool->lock);
+        if (job >= total)
+            break;
+
+        GenConfig cfg = *pool->gen;
+        cfg.seed = pool->seeds[job / pool->num_methods];
+
+        MemMgr mgr;
+        if (!init_mem_mgr(&mgr, pool->methods[job % pool->num_methods], cfg.capacity))
+        {
+            pthread_mutex_lock(&pool->lock);
+            pool->failed = true;
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        mgr.verbosity = VERBOSITY_OFF;
+        mgr.compact_on_fail = pool->compact;
+        mgr.out = NULL;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        GenFeed feed;
+        gen_feed_init(&feed, &cfg);
+        if (!run_event_sim(&mgr, gen_feed_next, &feed, &pool->samples[job]))
+        {
+            destroy_mem_mgr(&mgr);
+            pthread_mutex_lock(&pool->lock);
+            pool->failed = true;
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        finish_stats(&mgr, &pool->samples[job]);
+        if (pool->exporter != NULL)
+        {
+            export_run(pool->exporter, &mgr, "sweep", cfg.seed, &pool->samples[job],
+                       (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+        }
+        destroy_mem_mgr(&mgr);
+    }
+    return NULL;
+}
+
+bool run_sweep(const GenConfig *gen, const AllocMethod methods[], int num_methods, int trials, bool compact,
+               Exporter *exporter)
+{
+    SweepPool pool = {0};
+    pool.gen = gen;
+    pool.compact = compact;
+    pool.exporter = exporter;
+    pool.methods = methods;
+    pool.num_methods = num_methods;
+    pool.trials = trials;
+    pool.seeds = malloc(sizeof(unsigned long long) * trials);
+    pool.samples = calloc((size_t)trials * num_methods, sizeof(Stats));
+    pthread_mutex_init(&pool.lock, NULL);
+
+    long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_workers < 1)
+        num_workers = 1;
+    if (num_workers > trials * num_methods)
+        num_workers = trials * num_methods;
+    pthread_t *workers = malloc(sizeof(pthread_t) * num_workers);
+
+    if (pool.seeds == NULL || pool.samples == NULL || workers == NULL)
+    {
+        fprintf(stderr, "Error: Out of memory setting up sweep.\n");
+        free(pool.seeds);
+        free(pool.samples);
+        free(workers);
+        pthread_mutex_destroy(&pool.lock);
+        return false;
+    }
+
+    Rng seeder = {gen->seed};
+    for (int i = 0; i < trials; i++)
+    {
+        pool.seeds[i] = rng_next(&seeder);
+    }
+
+    printf("\nRunning %d trials x %d strategies on %ld worker threads...\n", trials, num_methods, num_workers);
+
+    int started = 0;
+    for (; started < num_workers; started++)
+    {
+        if (pthread_create(&workers[started], NULL, sweep_worker, &pool) != 0)
+            break;
+    }
+    if (started == 0)
+        sweep_worker(&pool);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    bool ok = !pool.failed;
+    if (ok)
+        print_sweep_summary(methods, num_methods, pool.samples, trials);
+    else
+        fprintf(stderr, "Error: Out of memory during sweep.\n");
+
+    free(pool.seeds);
+    free(pool.samples);
+    free(workers);
+    pthread_mutex_destroy(&pool.lock);
+    return ok;
+}
+
+void print_sweep_summary(const AllocMethod methods[], int num_methods, const Stats samples[], int trials)
+{
+    double *values = malloc(sizeof(double) * trials);
+    if (values == NULL)
+        return;
+
+    printf("\n=== Sweep Summary (%d trials, mean +/- 95%% CI) ===\n", trials);
+    printf("%-10s %-17s %-17s %-17s %-17s\n", "Strategy", "Success Rate", "Peak Usage", "Avg Usage", "Fragmentation");
+    printf("----------------------------------------------------------------------------------\n");
+
+    for (int m = 0; m < num_methods; m++)
+    {
+        char cells[4][32];
+
+        for (int col = 0; col < 4; col++)
+        {
+            for (int t = 0; t < trials; t++)
+            {
+                const Stats *st = &samples[t * num_methods + m];
+                switch (col)
+                {
+                case 0:
+                    values[t] = (st->alloc_tries > 0) ? (double)st->alloc_success / st->alloc_tries * 100.0 : 0.0;
+                    break;
+                case 1:
+                    values[t] = st->max_usage * 100.0;
+                    break;
+                case 2:
+                    values[t] = st->avg_usage * 100.0;
+                    break;
+                default:
+                    values[t] = st->frag_percent;
+                    break;
+                }
+            }
+
+            double mean, half_width;
+            sample_interval(values, trials, &mean, &half_width);
+            snprintf(cells[col], sizeof(cells[col]), "%.1f +/- %.1f%%", mean, half_width);
+        }
+
+        printf("%-10s %-17s %-17s %-17s %-17s\n", method_title(methods[m]), cells[0], cells[1], cells[2], cells[3]);
+    }
+
+    free(values);
+}
+
+bool is_binary_trace(const char *filename)
+{
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    FILE *in_file = fopen(filename, "rb");
+    if (in_file == NULL)
         return false;
-    }
 
-    return true;
+    bool match = fread(magic, 1, sizeof(magic), in_file) == sizeof(magic) &&
+                 memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+    fclose(in_file);
+    return match;
 }
 
-void print_mem_simple(MemMgr *mgr, Proc procs[], int num_procs)
+bool map_trace(const char *filename, MappedTrace *trace)
 {
-    printf("\nMemory Summary: Used: %d KB (%.1f%%), Free: %d KB (%.1f%%)\n",
-           mgr->full_size - mgr->avail_size,
-           ((double)(mgr->full_size - mgr->avail_size) / mgr->full_size) * 100.0,
-           mgr->avail_size,
-           ((double)mgr->avail_size / mgr->full_size) * 100.0);
+    trace->base = NULL;
+    trace->length = 0;
 
-    int free_count = 0;
-    for (int i = 0; i < mgr->num_blocks; i++)
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1)
     {
-        if (mgr->segments[i].available)
-            free_count++;
+        fprintf(stderr, "Error: Could not open trace file '%s'\n", filename);
+        return false;
     }
 
-    printf("Blocks: Total: %d, Free: %d\n", mgr->num_blocks, free_count);
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(TraceHeader))
+    {
+        fprintf(stderr, "Error: Trace file '%s' is truncated\n", filename);
+        close(fd);
+        return false;
+    }
 
-    int running = 0, terminated = 0, new_count = 0;
-    for (int i = 0; i < num_procs; i++)
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
     {
-        if (procs[i].status == PROC_ACTIVE)
-            running++;
-        else if (procs[i].status == PROC_DONE)
-            terminated++;
-        else if (procs[i].status == PROC_NEW)
-            new_count++;
+        fprintf(stderr, "Error: Could not map trace file '%s'\n", filename);
+        return false;
+    }
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+    /* count is bounded by the file size before it is multiplied, so a crafted header cannot wrap the check */
+    const TraceHeader *header = base;
+    size_t max_records = ((size_t)st.st_size - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 || header->version != TRACE_VERSION ||
+        header->count < 0 || (unsigned long long)header->count > max_records || header->capacity <= 0 ||
+        (size_t)st.st_size != sizeof(TraceHeader) + (size_t)header->count * sizeof(TraceRecord))
+    {
+        fprintf(stderr, "Error: '%s' is not a valid version %d trace for this machine\n", filename, TRACE_VERSION);
+        munmap(base, st.st_size);
+        return false;
     }
 
-    printf("Processes: Running: %d, Terminated: %d, Unallocated: %d\n",
-           running, terminated, new_count);
+    trace->base = base;
+    trace->length = st.st_size;
+    trace->header = header;
+    trace->records = (const TraceRecord *)(header + 1);
+    return true;
 }
 
-void print_mem_detailed(MemMgr *mgr, Proc procs[], int num_procs)
+void unmap_trace(MappedTrace *trace)
 {
-    printf("\nMemory Allocation Table:\n");
-    printf("%-4s %-15s %-12s %-12s\n", "ID", "State", "Size", "Location");
-    printf("------------------------------------------\n");
-
-    for (int i = 0; i < num_procs; i++)
-    {
-        if (procs[i].status != PROC_NEW)
-        {
-            const char *state_str = (procs[i].status == PROC_ACTIVE) ? "Running" : "Terminated";
-
-            printf("%-4d %-15s %-12d ",
-                   procs[i].id,
-                   state_str,
-                   procs[i].req_size);
-
-            if (procs[i].block_idx != -1)
-            {
-                printf("%-12d\n", mgr->segments[procs[i].block_idx].begin_addr);
-            }
-            else
-            {
-                printf("N/A\n");
-            }
-        }
-    }
-
-    printf("\nMemory Status:\n");
-    printf("Total Memory: %d KB, Used: %d KB, Free: %d KB\n",
-           mgr->full_size,
-           mgr->full_size - mgr->avail_size,
-           mgr->avail_size);
+    if (trace->base != NULL)
+        munmap(trace->base, trace->length);
+    trace->base = NULL;
+}
 
-    printf("\nBlock List Details:\n");
-    printf("%-8s %-8s %-16s %-8s\n", "Start", "Size", "Status", "Process");
-    printf("------------------------------------------\n");
+bool mapped_feed_next(void *ctx, Proc *out)
+{
+    MappedFeed *feed = ctx;
 
-    for (int i = 0; i < mgr->num_blocks; i++)
+    while (feed->pos < feed->count)
     {
-        printf("%-8d %-8d %-16s %-8d\n",
-               mgr->segments[i].begin_addr,
-               mgr->segments[i].chunk_size,
-               mgr->segments[i].available ? "Free" : "Allocated",
-               mgr->segments[i].proc_id);
-    }
+        const TraceRecord *rec = &feed->records[feed->pos++];
+        if (rec->req_size <= 0)
+            continue;
 
-    printf("\n");
+        out->id = rec->id;
+        out->req_size = rec->req_size;
+        out->arrival_time = rec->arrival_time;
+        out->duration = rec->duration;
+        out->status = PROC_NEW;
+        out->handle = NO_BLOCK;
+        return true;
+    }
+    return false;
 }
 
-void update_frag_metrics(MemMgr *mgr, Proc procs[],
-                               int num_procs, Stats *stats)
+/* traces are stored in arrival order, so the table comes back in that order rather than the text file's */
+bool load_procs_from_trace(const char *filename, Proc **procs, int *num_procs, int *mem_capacity, long long *bytes_read)
 {
-    stats->ext_frag = 0;
-    stats->frag_percent = 0.0;
-    stats->avg_frag_size = 0.0;
-
-    int total_free_size = 0;
-    int free_block_count = 0;
+    MappedTrace trace;
+    if (!map_trace(filename, &trace))
+        return false;
 
-    for (int i = 0; i < mgr->num_blocks; i++)
+    if (trace.header->count > INT_MAX - 1)
     {
-        if (mgr->segments[i].available)
-        {
-            stats->ext_frag++;
-            total_free_size += mgr->segments[i].chunk_size;
-            free_block_count++;
-        }
+        fprintf(stderr, "Error: Trace has too many processes to load into a table\n");
+        unmap_trace(&trace);
+        return false;
     }
 
-    if (free_block_count > 0)
+    *procs = malloc(sizeof(Proc) * (trace.header->count + 1));
+    if (*procs == NULL)
     {
-        stats->avg_frag_size = (double)total_free_size / free_block_count;
+        fprintf(stderr, "Error: Out of memory loading trace\n");
+        unmap_trace(&trace);
+        return false;
     }
 
-    if (mgr->avail_size > 0)
+    MappedFeed feed = {trace.records, trace.header->count, 0};
+    *num_procs = 0;
+    while (mapped_feed_next(&feed, &(*procs)[*num_procs]))
     {
-        if (free_block_count > 1)
-        {
-            int largest_free_block = 0;
-            for (int i = 0; i < mgr->num_blocks; i++)
-            {
-                if (mgr->segments[i].available && mgr->segments[i].chunk_size > largest_free_block)
-                {
-                    largest_free_block = mgr->segments[i].chunk_size;
-                }
-            }
-
-            stats->frag_percent =
-                ((double)(mgr->avail_size - largest_free_block) / mgr->avail_size) * 100.0;
-        }
+        (*num_procs)++;
     }
+    *mem_capacity = trace.header->capacity;
+    *bytes_read = trace.length;
+
+    unmap_trace(&trace);
+    return true;
 }
 
-void run_sim(MemMgr *mgr, AllocMethod method,
-                     Proc procs[], int num_procs, Stats *stats)
+bool convert_trace(const char *text_file, const char *bin_file)
 {
-    memset(stats, 0, sizeof(Stats));
-
-    printf("\n=== %s Strategy Simulation ===\n",
-           method == FIRST_APPROACH ? "First-Fit" : (method == BEST_APPROACH ? "Best-Fit" : "Worst-Fit"));
-
-    printf("\n--- Phase 1: Initial Process Allocation ---\n");
-    int num_to_allocate;
-    printf("How many processes do you want to allocate initially? (max %d): ", num_procs);
-    scanf("%d", &num_to_allocate);
+    Proc *procs = NULL;
+    int num_procs = 0;
+    int mem_capacity = 0;
+    long long bytes_read = 0;
+    struct timespec start, end;
 
-    if (num_to_allocate <= 0)
-        num_to_allocate = 1;
-    else if (num_to_allocate > num_procs)
-        num_to_allocate = num_procs;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!load_procs_from_file(text_file, &procs, &num_procs, &mem_capacity, &bytes_read))
+        return false;
+    clock_gettime(CLOCK_MONOTONIC, &end);
 
-    double total_util = 0.0;
-    int util_samples = 0;
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Parsed %.2f MB in %.3f s (%.1f MB/s)\n", bytes_read / 1e6, secs,
+           (secs > 0.0) ? bytes_read / 1e6 / secs : 0.0);
 
-    for (int i = 0; i < num_to_allocate; i++)
+    int *order = sort_by_arrival(procs, num_procs);
+    FILE *out_file = fopen(bin_file, "wb");
+    if (order == NULL || out_file == NULL)
     {
-        stats->alloc_tries++;
-
-        if (allocate_mem(mgr, &procs[i]))
-        {
-            stats->alloc_success++;
-            printf("P%d ", procs[i].id);
-        }
-        else
-        {
-            stats->alloc_fails++;
-            printf("P%d(FAILED) ", procs[i].id);
-        }
+        fprintf(stderr, "Error: Could not write trace file '%s'\n", bin_file);
+        if (out_file != NULL)
+            fclose(out_file);
+        free(order);
+        free(procs);
+        return false;
     }
-    printf("\n");
 
-    double current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
-    total_util += current_util;
-    util_samples++;
-    stats->max_usage = current_util;
-
-    print_mem_simple(mgr, procs, num_procs);
+    TraceHeader header = {{0}, TRACE_VERSION, mem_capacity, num_procs};
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    fwrite(&header, sizeof(header), 1, out_file);
 
-    printf("\n--- Phase 2: Process Termination ---\n");
-    printf("Running processes: ");
-    int running_count = 0;
     for (int i = 0; i < num_procs; i++)
     {
-        if (procs[i].status == PROC_ACTIVE)
-        {
-            printf("P%d ", procs[i].id);
-            running_count++;
-        }
+        const Proc *proc = &procs[order[i]];
+        TraceRecord rec = {proc->id, proc->req_size, proc->arrival_time, proc->duration};
+        fwrite(&rec, sizeof(rec), 1, out_file);
     }
-    printf("\n");
 
-    if (running_count > 0)
-    {
-        printf("Enter number of processes to terminate ([0] for none, [-1] for all, [1-%d] for specific processes): ", running_count);
-        int num_to_terminate;
-        scanf("%d", &num_to_terminate);
+    bool ok = !ferror(out_file);
+    if (fclose(out_file) != 0)
+        ok = false;
+    if (!ok)
+        fprintf(stderr, "Error: Failed writing trace to '%s'\n", bin_file);
 
-        if (num_to_terminate == -1)
-        {
-            printf("Terminating all running processes\n");
-            for (int i = 0; i < num_procs; i++)
-            {
-                if (procs[i].status == PROC_ACTIVE)
-                {
-                    free_mem(mgr, &procs[i]);
-                }
-            }
-        }
-        else
-        {
-            if (num_to_terminate < 0)
-                num_to_terminate = 0;
-            if (num_to_terminate > running_count)
-                num_to_terminate = running_count;
+    free(order);
+    free(procs);
+    return ok;
+}
 
-            for (int i = 0; i < num_to_terminate; i++)
-            {
-                int process_id;
-                printf("Enter process ID to terminate: ");
-                scanf("%d", &process_id);
+static bool pending_before(const PendingProc *a, const PendingProc *b)
+{
+    if (a->proc.arrival_time != b->proc.arrival_time)
+        return a->proc.arrival_time < b->proc.arrival_time;
+    return a->seq < b->seq;
+}
 
-                bool found = false;
-                for (int j = 0; j < num_procs; j++)
-                {
-                    if (procs[j].id == process_id && procs[j].status == PROC_ACTIVE)
-                    {
-                        found = true;
-                        free_mem(mgr, &procs[j]);
-                        printf("Terminated P%d\n", process_id);
-                        break;
-                    }
-                }
+static void window_push(TextFeed *feed, const Proc *proc)
+{
+    int pos = feed->len++;
+    PendingProc entry = {*proc, feed->next_seq++};
 
-                if (!found)
-                {
-                    printf("P%d not found or not running\n", process_id);
-                }
-            }
-        }
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (!pending_before(&entry, &feed->window[parent]))
+            break;
+        feed->window[pos] = feed->window[parent];
+        pos = parent;
     }
-    else
+    feed->window[pos] = entry;
+}
+
+static void window_pop(TextFeed *feed, Proc *out)
+{
+    *out = feed->window[0].proc;
+
+    PendingProc last = feed->window[--feed->len];
+    int pos = 0;
+    while (true)
     {
-        printf("No running processes to terminate.\n");
+        int child = 2 * pos + 1;
+        if (child >= feed->len)
+            break;
+        if (child + 1 < feed->len && pending_before(&feed->window[child + 1], &feed->window[child]))
+            child++;
+        if (!pending_before(&feed->window[child], &last))
+            break;
+        feed->window[pos] = feed->window[child];
+        pos = child;
     }
+    if (feed->len > 0)
+        feed->window[pos] = last;
+}
 
-    current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
-    total_util += current_util;
-    util_samples++;
+bool text_feed_open(TextFeed *feed, const char *filename, int window, bool warn)
+{
+    memset(feed, 0, sizeof(TextFeed));
 
-    print_mem_simple(mgr, procs, num_procs);
+    if (!line_reader_open(&feed->reader, filename))
+    {
+        return false;
+    }
 
-    printf("\n--- Phase 3: Additional Process Allocation ---\n");
-    printf("Remaining unallocated processes: ");
-    int unalloc_count = 0;
-    for (int i = 0; i < num_procs; i++)
+    feed->window = malloc(sizeof(PendingProc) * window);
+    if (feed->window == NULL)
     {
-        if (procs[i].status == PROC_NEW)
-        {
-            printf("P%d ", procs[i].id);
-            unalloc_count++;
-        }
+        fprintf(stderr, "Error: Out of memory allocating the reorder window\n");
+        line_reader_close(&feed->reader);
+        return false;
     }
-    printf("\n");
+    feed->cap = window;
+    feed->warn = warn;
 
-    if (unalloc_count > 0)
+    const char *line;
+    size_t len;
+    if (!line_reader_next(&feed->reader, &line, &len) || !parse_capacity_line(line, len, &feed->capacity))
     {
-        printf("How many more processes do you want to allocate ([0] for none, [1-%d] for specific processes): ", unalloc_count);
-        int more_to_allocate;
-        scanf("%d", &more_to_allocate);
+        fprintf(stderr, "Error: Line 1 in input file must give the memory size\n");
+        text_feed_close(feed);
+        return false;
+    }
+    feed->line_num++;
+    return true;
+}
 
-        if (more_to_allocate < 0)
-            more_to_allocate = 0;
-        if (more_to_allocate > unalloc_count)
-            more_to_allocate = unalloc_count;
+void text_feed_close(TextFeed *feed)
+{
+    line_reader_close(&feed->reader);
+    free(feed->window);
+    feed->window = NULL;
+}
 
-        int alloc_count = 0;
+bool text_feed_next(void *ctx, Proc *out)
+{
+    TextFeed *feed = ctx;
+    const char *line;
+    size_t len;
 
-        for (int i = 0; i < num_procs && alloc_count < more_to_allocate; i++)
-        {
-            if (procs[i].status == PROC_NEW)
-            {
-                stats->alloc_tries++;
+    while (feed->len < feed->cap && line_reader_next(&feed->reader, &line, &len))
+    {
+        Proc proc;
+        feed->line_num++;
+        if (parse_proc_line(line, len, feed->line_num, &proc, feed->warn))
+            window_push(feed, &proc);
+    }
 
-                if (allocate_mem(mgr, &procs[i]))
-                {
-                    stats->alloc_success++;
-                    printf("P%d ", procs[i].id);
-                }
-                else
-                {
-                    stats->alloc_fails++;
-                    printf("P%d(FAILED) ", procs[i].id);
-                }
+    if (feed->len == 0)
+        return false;
 
-                alloc_count++;
-            }
-        }
-        printf("\n");
-    }
-    else
+    window_pop(feed, out);
+    return true;
+}
+
+bool exporter_open(Exporter *exp, const char *filename, const char *source)
+{
+    const char *ext = strrchr(filename, '.');
+    exp->format = (ext != NULL && (strcmp(ext, ".json") == 0 || strcmp(ext, ".jsonl") == 0)) ? EXPORT_JSON : EXPORT_CSV;
+    exp->source = source;
+
+    /* invocations can start within the same second, so mix the pid into a nanosecond clock */
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    Rng mix = {((unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec) ^
+               ((unsigned long long)getpid() << 32)};
+    exp->run_id = rng_next(&mix);
+
+    exp->out = fopen(filename, "a");
+    if (exp->out == NULL)
     {
-        printf("No more processes to allocate.\n");
+        fprintf(stderr, "Error: Could not open export file '%s'\n", filename);
+        return false;
     }
+    pthread_mutex_init(&exp->lock, NULL);
 
-    current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
-    total_util += current_util;
-    util_samples++;
-    if (current_util > stats->max_usage)
+    /* appending lets many runs share one file; only a fresh CSV gets a header */
+    if (exp->format == EXPORT_CSV && ftell(exp->out) == 0)
     {
-        stats->max_usage = current_util;
+        fprintf(exp->out, "run,source,mode,strategy,seed,capacity,elapsed_s,"
+                          "alloc_tries,alloc_success,alloc_fails,avg_usage,max_usage,"
+                          "ext_frag,frag_percent,avg_frag_size,int_frag,int_frag_percent,"
+                          "alloc_p50_ns,alloc_p99_ns,alloc_p999_ns,alloc_max_ns,"
+                          "free_p50_ns,free_p99_ns,free_p999_ns,free_max_ns,"
+                          "compactions,compact_kb,compact_ms,blocks\n");
     }
+    return true;
+}
 
-    print_mem_simple(mgr, procs, num_procs);
+void exporter_close(Exporter *exp)
+{
+    if (exp->out == NULL)
+        return;
+    fclose(exp->out);
+    exp->out = NULL;
+    pthread_mutex_destroy(&exp->lock);
+}
 
-    printf("\n--- Phase 4: Large Process Allocation ---\n");
-    float pct_input = 0.0f;
-    do
+static void export_string(FILE *out, const char *str, ExportFormat format)
+{
+    char quote = '"';
+    char escape = (format == EXPORT_JSON) ? '\\' : '"';
+
+    fputc(quote, out);
+    for (; *str != '\0'; str++)
     {
-        printf("Enter size for a large process (P9999) allocation (as %% of available free memory, 1–100): ");
-        if (scanf("%f", &pct_input) != 1)
-        {
-            printf("Invalid input. Please enter a number.\n");
-            while (getchar() != '\n')
-                ;
-            pct_input = 0.0f;
-        }
-        else if (pct_input < 1.0f || pct_input > 100.0f)
-        {
-            printf("Please enter a valid percentage between 1 and 100.\n");
-            pct_input = 0.0f;
-        }
-    } while (pct_input == 0.0f);
+        if (*str == quote || (format == EXPORT_JSON && *str == '\\'))
+            fputc(escape, out);
+        if (format == EXPORT_JSON && (unsigned char)*str < 0x20)
+            fprintf(out, "\\u%04x", *str);
+        else
+            fputc(*str, out);
+    }
+    fputc(quote, out);
+}
 
-    int large_size = (int)((mgr->avail_size * pct_input) / 100.0f);
+/* one line per strategy run; the block list is [start,size,proc] triples, proc -1 when free */
+void export_run(Exporter *exp, MemMgr *mgr, const char *mode, unsigned long long seed,
+                const Stats *stats, double elapsed)
+{
+    FILE *out = exp->out;
+    bool json = (exp->format == EXPORT_JSON);
 
-    Proc large_proc;
-    large_proc.id = 9999;
-    large_proc.req_size = large_size;
-    large_proc.status = PROC_NEW;
-    large_proc.block_idx = -1;
+    /* a negative elapsed time means the run waited on prompts, so wall time is not exported */
+    char elapsed_str[32];
+    if (elapsed < 0.0)
+        snprintf(elapsed_str, sizeof(elapsed_str), "%s", json ? "null" : "");
+    else
+        snprintf(elapsed_str, sizeof(elapsed_str), "%.6f", elapsed);
 
-    stats->alloc_tries++;
-    printf("Attempting large allocation (P9999, %dKB - %.2f%% of available free memory): ", large_proc.req_size, pct_input);
+    pthread_mutex_lock(&exp->lock);
 
-    if (allocate_mem(mgr, &large_proc))
+    if (json)
     {
-        stats->alloc_success++;
-        printf("SUCCESS\n");
-        procs[num_procs] = large_proc;
-        num_procs++;
+        fprintf(out, "{\"run\":\"%016llx\",\"source\":", exp->run_id);
+        export_string(out, exp->source, exp->format);
+        fprintf(out, ",\"mode\":\"%s\",\"strategy\":\"%s\",\"seed\":%llu,\"capacity\":%d,\"elapsed_s\":%s,"
+                     "\"alloc_tries\":%d,\"alloc_success\":%d,\"alloc_fails\":%d,\"avg_usage\":%.6f,\"max_usage\":%.6f,"
+                     "\"ext_frag\":%d,\"frag_percent\":%.4f,\"avg_frag_size\":%.4f,\"int_frag\":%d,\"int_frag_percent\":%.4f,"
+                     "\"alloc_ns\":[%.0f,%.0f,%.0f,%.0f],\"free_ns\":[%.0f,%.0f,%.0f,%.0f],"
+                     "\"compactions\":%d,\"compact_kb\":%lld,\"compact_ms\":%.3f,\"blocks\":[",
+                mode, method_title(mgr->method), seed, mgr->full_size, elapsed_str,
+                stats->alloc_tries, stats->alloc_success, stats->alloc_fails, stats->avg_usage, stats->max_usage,
+                stats->ext_frag, stats->frag_percent, stats->avg_frag_size, stats->int_frag, stats->int_frag_percent,
+                stats->alloc_ns[0], stats->alloc_ns[1], stats->alloc_ns[2], stats->alloc_ns[3],
+                stats->free_ns[0], stats->free_ns[1], stats->free_ns[2], stats->free_ns[3],
+                stats->compactions, stats->compact_moved, stats->compact_ms);
     }
     else
     {
-        stats->alloc_fails++;
-        printf("FAILED (not enough contiguous space)\n");
-    }
-
-    current_util = (double)(mgr->full_size - mgr->avail_size) / mgr->full_size;
-    total_util += current_util;
-    util_samples++;
-    if (current_util > stats->max_usage)
-    {
-        stats->max_usage = current_util;
+        fprintf(out, "%016llx,", exp->run_id);
+        export_string(out, exp->source, exp->format);
+        fprintf(out, ",%s,%s,%llu,%d,%s,%d,%d,%d,%.6f,%.6f,%d,%.4f,%.4f,%d,%.4f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%d,%lld,%.3f,",
+                mode, method_title(mgr->method), seed, mgr->full_size, elapsed_str,
+                stats->alloc_tries, stats->alloc_success, stats->alloc_fails, stats->avg_usage, stats->max_usage,
+                stats->ext_frag, stats->frag_percent, stats->avg_frag_size, stats->int_frag, stats->int_frag_percent,
+                stats->alloc_ns[0], stats->alloc_ns[1], stats->alloc_ns[2], stats->alloc_ns[3],
+                stats->free_ns[0], stats->free_ns[1], stats->free_ns[2], stats->free_ns[3],
+                stats->compactions, stats->compact_moved, stats->compact_ms);
     }
 
-    if (util_samples > 0)
+    for (int blk = mgr->head; blk != -1; blk = block_at(mgr, blk)->next)
     {
-        stats->avg_usage = total_util / util_samples;
+        MemBlock *b = block_at(mgr, blk);
+        int proc_id = b->available ? -1 : b->proc_id;
+        if (json)
+            fprintf(out, "%s[%d,%d,%d]", (blk == mgr->head) ? "" : ",", b->begin_addr, b->chunk_size, proc_id);
+        else
+            fprintf(out, "%s%d:%d:%d", (blk == mgr->head) ? "" : ";", b->begin_addr, b->chunk_size, proc_id);
     }
+    fprintf(out, json ? "]}\n" : "\n");
 
-    update_frag_metrics(mgr, procs, num_procs, stats);
-    print_mem_simple(mgr, procs, num_procs);
-
-    printf("\n--- Final Memory State (Detailed) ---\n");
-    print_mem_detailed(mgr, procs, num_procs);
-
-    printf("\n--- Final Results (%s) ---\n",
-           method == FIRST_APPROACH ? "First-Fit" : (method == BEST_APPROACH ? "Best-Fit" : "Worst-Fit"));
-
-    printf("Success Rate: %.1f%% (%d/%d)\n",
-           ((double)stats->alloc_success / stats->alloc_tries) * 100.0,
-           stats->alloc_success, stats->alloc_tries);
-    printf("Peak Memory Usage: %.1f%%\n", stats->max_usage * 100.0);
-    printf("Fragmentation: %.1f%%\n", stats->frag_percent);
-    printf("Final Block Count: %d\n", mgr->num_blocks);
-
-    printf("\n--- %s Simulation Completed ---\n",
-           method == FIRST_APPROACH ? "First-Fit" : (method == BEST_APPROACH ? "Best-Fit" : "Worst-Fit"));
-    printf("\n\n****************************************************************************************************************************\n\n");
+    pthread_mutex_unlock(&exp->lock);
 }
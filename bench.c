@@ -0,0 +1,191 @@
+#define main pa4_main
+#include "PA4.c"
+#undef main
+
+#define BENCH_SEED 12345
+#define BENCH_BATCH 1024
+#define BENCH_MIN_OPS 200000
+#define BENCH_MAX_SIZE 64
+#define DEFAULT_BENCH_CSV "bench.csv"
+
+typedef struct
+{
+    double find_ns;
+    double alloc_ns;
+    double free_ns;
+} BenchResult;
+
+static double elapsed_ns(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+static int bench_size(Rng *rng)
+{
+    return 1 + (int)(rng_next(rng) % BENCH_MAX_SIZE);
+}
+
+static int bench_find(MemMgr *mgr, int size)
+{
+    switch (mgr->method)
+    {
+    case FIRST_APPROACH:
+        return find_first_fit(mgr, size);
+    case BEST_APPROACH:
+        return find_best_fit(mgr, size);
+    case WORST_APPROACH:
+        return find_worst_fit(mgr, size);
+    case NEXT_APPROACH:
+        return find_next_fit(mgr, size);
+    case BUDDY_APPROACH:
+        return find_buddy_fit(mgr, size);
+    case TLSF_APPROACH:
+        return find_tlsf_fit(mgr, size);
+    }
+    return -1;
+}
+
+/*
+ * Fills the heap with num_blocks allocations, frees every other one so free
+ * holes are spread across the whole address range, then times batches of
+ * frees and re-allocations at that steady population.
+ */
+static bool bench_run(AllocMethod method, int num_blocks, BenchResult *result)
+{
+    long long capacity = 1;
+    while (capacity < (long long)num_blocks * BENCH_MAX_SIZE * 2)
+        capacity *= 2;
+
+    MemMgr mgr;
+    Proc *procs = malloc(sizeof(Proc) * num_blocks);
+    int *live = malloc(sizeof(int) * num_blocks);
+    if (procs == NULL || live == NULL || !init_mem_mgr(&mgr, method, (int)capacity))
+    {
+        free(procs);
+        free(live);
+        return false;
+    }
+    mgr.verbosity = VERBOSITY_OFF;
+
+    Rng rng = {BENCH_SEED};
+    for (int i = 0; i < num_blocks; i++)
+    {
+        procs[i].id = i;
+        procs[i].req_size = bench_size(&rng);
+        procs[i].status = PROC_NEW;
+        procs[i].handle = NO_BLOCK;
+        allocate_mem(&mgr, &procs[i]);
+    }
+
+    int num_live = 0;
+    for (int i = 0; i < num_blocks; i++)
+    {
+        if (i % 2 == 1)
+            free_mem(&mgr, &procs[i]);
+        else
+            live[num_live++] = i;
+    }
+
+    int ops = (num_blocks > BENCH_MIN_OPS) ? num_blocks : BENCH_MIN_OPS;
+    int batch = (BENCH_BATCH < num_live) ? BENCH_BATCH : num_live;
+    double find_total = 0.0, alloc_total = 0.0, free_total = 0.0;
+    long long finds = 0, allocs = 0, frees = 0;
+    volatile int sink = 0;
+    int picked[BENCH_BATCH];
+    int sizes[BENCH_BATCH];
+    struct timespec start, end;
+
+    for (int done = 0; done < ops; done += batch)
+    {
+        for (int k = 0; k < batch; k++)
+        {
+            int pos = (int)(rng_next(&rng) % (num_live - k));
+            picked[k] = live[pos];
+            live[pos] = live[num_live - k - 1];
+            live[num_live - k - 1] = picked[k];
+            sizes[k] = bench_size(&rng);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int k = 0; k < batch; k++)
+        {
+            free_mem(&mgr, &procs[picked[k]]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free_total += elapsed_ns(&start, &end);
+        frees += batch;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int k = 0; k < batch; k++)
+        {
+            sink += bench_find(&mgr, sizes[k]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        find_total += elapsed_ns(&start, &end);
+        finds += batch;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int k = 0; k < batch; k++)
+        {
+            procs[picked[k]].req_size = sizes[k];
+            procs[picked[k]].status = PROC_NEW;
+            allocate_mem(&mgr, &procs[picked[k]]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        alloc_total += elapsed_ns(&start, &end);
+        allocs += batch;
+    }
+
+    result->find_ns = find_total / finds;
+    result->alloc_ns = alloc_total / allocs;
+    result->free_ns = free_total / frees;
+
+    destroy_mem_mgr(&mgr);
+    free(procs);
+    free(live);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int max_blocks = (argc > 1) ? atoi(argv[1]) : 1000000;
+    const char *csv_file = (argc > 2) ? argv[2] : DEFAULT_BENCH_CSV;
+
+    FILE *csv = fopen(csv_file, "w");
+    if (csv == NULL)
+    {
+        fprintf(stderr, "Error: Could not open output file '%s'\n", csv_file);
+        return EXIT_FAILURE;
+    }
+    fprintf(csv, "strategy,blocks,find_ns,alloc_ns,free_ns,ops_per_sec\n");
+
+    AllocMethod methods[] = {FIRST_APPROACH, BEST_APPROACH, WORST_APPROACH, NEXT_APPROACH, BUDDY_APPROACH, TLSF_APPROACH};
+    const int num_methods = sizeof(methods) / sizeof(methods[0]);
+
+    printf("%-10s %-10s %-12s %-12s %-12s %-14s\n", "Strategy", "Blocks", "Find (ns)", "Alloc (ns)", "Free (ns)", "Ops/sec");
+    printf("------------------------------------------------------------------------\n");
+
+    for (int i = 0; i < num_methods; i++)
+    {
+        for (int num_blocks = 10; num_blocks <= max_blocks; num_blocks *= 10)
+        {
+            BenchResult result;
+            if (!bench_run(methods[i], num_blocks, &result))
+            {
+                fprintf(stderr, "Error: Out of memory benchmarking %d blocks\n", num_blocks);
+                fclose(csv);
+                return EXIT_FAILURE;
+            }
+
+            double ops_per_sec = 2e9 / (result.alloc_ns + result.free_ns);
+            printf("%-10s %-10d %-12.1f %-12.1f %-12.1f %-14.0f\n", method_title(methods[i]), num_blocks,
+                   result.find_ns, result.alloc_ns, result.free_ns, ops_per_sec);
+            fprintf(csv, "%s,%d,%.1f,%.1f,%.1f,%.0f\n", method_title(methods[i]), num_blocks,
+                    result.find_ns, result.alloc_ns, result.free_ns, ops_per_sec);
+        }
+    }
+
+    fclose(csv);
+    printf("\nScaling curve written to %s\n", csv_file);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+#define main pa4_main
+#include "PA4.c"
+#undef main
+
+#define CHECK_SEED 7
+#define CHECK_PROCS 3000
+#define CHECK_ROUNDS 60
+#define CHECK_OPS 20000
+#define CHECK_MAX_SIZE 300
+#define CHECK_COMPACT_EVERY 997
+
+static const char *check_failure;
+
+static int ref_first_fit(MemMgr *mgr, int size)
+{
+    for (int i = mgr->head; i != -1; i = block_at(mgr, i)->next)
+    {
+        if (block_at(mgr, i)->available && block_at(mgr, i)->chunk_size >= size)
+            return i;
+    }
+    return -1;
+}
+
+static int ref_next_fit(MemMgr *mgr, int size)
+{
+    for (int i = mgr->head; i != -1; i = block_at(mgr, i)->next)
+    {
+        MemBlock *b = block_at(mgr, i);
+        if (b->begin_addr >= mgr->rover_addr && b->available && b->chunk_size >= size)
+            return i;
+    }
+    return ref_first_fit(mgr, size);
+}
+
+/* best and worst fit break size ties by the lowest address, which the walk meets first */
+static int ref_fit(MemMgr *mgr, int size, bool best)
+{
+    int found = -1;
+    for (int i = mgr->head; i != -1; i = block_at(mgr, i)->next)
+    {
+        MemBlock *b = block_at(mgr, i);
+        if (!b->available || b->chunk_size < size)
+            continue;
+        if (found == -1 || (best ? b->chunk_size < block_at(mgr, found)->chunk_size
+                                 : b->chunk_size > block_at(mgr, found)->chunk_size))
+            found = i;
+    }
+    return found;
+}
+
+static bool check_fit(MemMgr *mgr, int size)
+{
+    int blk;
+    switch (mgr->method)
+    {
+    case FIRST_APPROACH:
+        return find_first_fit(mgr, size) == ref_first_fit(mgr, size);
+    case NEXT_APPROACH:
+        return find_next_fit(mgr, size) == ref_next_fit(mgr, size);
+    case BEST_APPROACH:
+        return find_best_fit(mgr, size) == ref_fit(mgr, size, true);
+    case WORST_APPROACH:
+        return find_worst_fit(mgr, size) == ref_fit(mgr, size, false);
+    case TLSF_APPROACH:
+        blk = find_tlsf_fit(mgr, size);
+        if (blk == -1)
+            return ref_first_fit(mgr, (int)tlsf_round_up((unsigned int)size)) == -1;
+        return block_at(mgr, blk)->available && block_at(mgr, blk)->chunk_size >= size;
+    case BUDDY_APPROACH:
+        blk = find_buddy_fit(mgr, size);
+        return blk == -1 || (block_at(mgr, blk)->available && block_at(mgr, blk)->chunk_size >= size);
+    }
+    return false;
+}
+
+/* recomputes every incrementally maintained counter from a full block walk */
+static bool check_mgr(MemMgr *mgr, Proc procs[], int num_procs)
+{
+    int free_hist[FREE_HIST_BUCKETS] = {0};
+    int free_blocks = 0, num_blocks = 0, largest = 0, addr = 0, prev = -1;
+    long long avail = 0, int_frag = 0;
+
+    for (int i = mgr->head; i != -1; i = block_at(mgr, i)->next)
+    {
+        MemBlock *b = block_at(mgr, i);
+        if (b->begin_addr != addr || b->prev != prev)
+        {
+            check_failure = "block list is not contiguous";
+            return false;
+        }
+        if (b->available)
+        {
+            free_blocks++;
+            avail += b->chunk_size;
+            free_hist[free_hist_bucket(b->chunk_size)]++;
+            if (b->chunk_size > largest)
+                largest = b->chunk_size;
+        }
+        else
+        {
+            int_frag += b->chunk_size - b->used_size;
+        }
+        addr += b->chunk_size;
+        prev = i;
+        num_blocks++;
+    }
+
+    if (addr != mgr->full_size || num_blocks != mgr->num_blocks)
+        check_failure = "blocks do not cover memory";
+    else if (free_blocks != mgr->free_blocks || avail != mgr->avail_size)
+        check_failure = "free block count or free size is stale";
+    else if (int_frag != mgr->int_frag)
+        check_failure = "internal fragmentation is stale";
+    else if (memcmp(free_hist, mgr->free_hist, sizeof(free_hist)) != 0)
+        check_failure = "free size histogram is stale";
+    else if (largest != largest_free_block(mgr))
+        check_failure = "largest free block is stale";
+    if (check_failure != NULL)
+        return false;
+
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (procs[i].status != PROC_ACTIVE)
+            continue;
+        int blk = resolve_handle(mgr, procs[i].handle);
+        if (blk == -1 || block_at(mgr, blk)->proc_id != procs[i].id)
+        {
+            check_failure = "process handle does not resolve to its block";
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Runs seeded random allocations and frees against every strategy, with
+ * periodic compaction, and after each operation compares the fit search
+ * and all cached metrics with a brute-force walk of the block list.
+ */
+int main(void)
+{
+    static MemMgr mgr;
+    static Proc procs[CHECK_PROCS];
+    Rng rng = {CHECK_SEED};
+    long long checks = 0;
+
+    AllocMethod methods[] = {FIRST_APPROACH, BEST_APPROACH, WORST_APPROACH, NEXT_APPROACH, BUDDY_APPROACH, TLSF_APPROACH};
+    const int num_methods = sizeof(methods) / sizeof(methods[0]);
+
+    for (int round = 0; round < CHECK_ROUNDS; round++)
+    {
+        AllocMethod method = methods[round % num_methods];
+        if (!init_mem_mgr(&mgr, method, 5000 + round * 37))
+        {
+            fprintf(stderr, "Error: Out of memory setting up check\n");
+            return EXIT_FAILURE;
+        }
+        mgr.verbosity = VERBOSITY_OFF;
+
+        for (int i = 0; i < CHECK_PROCS; i++)
+        {
+            procs[i].id = i;
+            procs[i].status = PROC_NEW;
+            procs[i].handle = NO_BLOCK;
+        }
+
+        for (int op = 0; op < CHECK_OPS; op++)
+        {
+            Proc *proc = &procs[rng_next(&rng) % CHECK_PROCS];
+            if (proc->status == PROC_ACTIVE)
+            {
+                free_mem(&mgr, proc);
+            }
+            else
+            {
+                proc->req_size = 1 + (int)(rng_next(&rng) % CHECK_MAX_SIZE);
+                proc->status = PROC_NEW;
+                if (!check_fit(&mgr, proc->req_size))
+                    check_failure = "fit search disagrees with a block walk";
+                else
+                    allocate_mem(&mgr, proc);
+            }
+
+            if (method != BUDDY_APPROACH && op % CHECK_COMPACT_EVERY == CHECK_COMPACT_EVERY - 1)
+                compact_mem(&mgr);
+
+            if (check_failure != NULL || !check_mgr(&mgr, procs, CHECK_PROCS))
+            {
+                printf("FAIL %s: %s after %d operations\n", method_title(method), check_failure, op + 1);
+                destroy_mem_mgr(&mgr);
+                return EXIT_FAILURE;
+            }
+            checks++;
+        }
+        destroy_mem_mgr(&mgr);
+    }
+
+    printf("ok: %lld operations checked across %d strategies\n", checks, num_methods);
+    return EXIT_SUCCESS;
+}